@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+// one driver and client for every thread; created on first use and left
+// for process exit
+struct Connection {
+  YdbDriver *drv = nullptr;
+  YdbQueryClient *qc = nullptr;
+  std::string error;
+};
+
+Connection &connection() {
+  static Connection conn = [] {
+    Connection c;
+    const char *endpoint = std::getenv("YDB_BENCH_ENDPOINT");
+    if (!endpoint) {
+      c.error = "YDB_BENCH_ENDPOINT is not set";
+      return c;
+    }
+    const char *database = std::getenv("YDB_BENCH_DATABASE");
+    YdbResultDetails *rd = ydb_result_details_create(0);
+    YdbDriverConfig *cfg = ydb_driver_config_create(rd);
+    if (cfg &&
+        ydb_driver_config_set_endpoint(cfg, endpoint, rd) == YDB_OK &&
+        ydb_driver_config_set_database(cfg, database ? database : "/local",
+                                       rd) == YDB_OK &&
+        ydb_driver_config_set_session_pool_size(cfg, 1, 64, rd) == YDB_OK) {
+      c.drv = ydb_driver_create(cfg, rd);
+    }
+    ydb_driver_config_free(cfg);
+    if (c.drv) {
+      c.qc = ydb_query_client_create(c.drv, rd);
+    }
+    if (!c.qc) {
+      c.error = std::string("connect failed: ") + get_message(rd);
+    }
+    ydb_result_details_free(rd);
+    return c;
+  }();
+  return conn;
+}
+
+double percentile(std::vector<double> &samples, double q) {
+  if (samples.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(q * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
+
+// state.range(0): 1 runs the query with a prepared handle
+void BM_EndToEndSelect(benchmark::State &state) {
+  Connection &conn = connection();
+  if (!conn.qc) {
+    state.SkipWithError(conn.error.c_str());
+    return;
+  }
+  const char *yql = "DECLARE $id AS Int64; SELECT $id AS id;";
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  YdbPreparedQuery *pq = nullptr;
+  if (state.range(0) && ydb_query_prepare(conn.qc, yql, &pq, rd) != YDB_OK) {
+    state.SkipWithError(get_message(rd));
+    ydb_result_details_free(rd);
+    return;
+  }
+  YdbQueryParams *params = ydb_query_params_create(rd);
+
+  std::vector<double> latencies_us;
+  int64_t errors = 0;
+  int64_t id = 0;
+  for (auto _ : state) {
+    ydb_result_details_reset(rd);
+    ydb_params_set_int64(params, "$id", ++id, rd);
+    YdbResultSets *out = nullptr;
+    const auto start = std::chrono::steady_clock::now();
+    // both arms take the same single-attempt path, only the text differs
+    const ydb_status_t st =
+        pq ? ydb_query_execute_prepared(conn.qc, pq, params, &out, rd)
+           : ydb_query_NOtx_execute(conn.qc, yql, params, &out, rd);
+    latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    if (st != YDB_OK) {
+      ++errors;
+    }
+    ydb_resultsets_free(out, nullptr);
+  }
+
+  using benchmark::Counter;
+  state.counters["qps"] = Counter(static_cast<double>(state.iterations()),
+                                  Counter::kIsRate);
+  state.counters["errors"] = Counter(static_cast<double>(errors));
+  state.counters["p50_us"] =
+      Counter(percentile(latencies_us, 0.50), Counter::kAvgThreads);
+  state.counters["p99_us"] =
+      Counter(percentile(latencies_us, 0.99), Counter::kAvgThreads);
+
+  ydb_query_params_free(params, nullptr);
+  ydb_result_details_free(rd);
+}
+BENCHMARK(BM_EndToEndSelect)
+    ->ArgName("prepared")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->MinTime(2.0);
+} // namespace
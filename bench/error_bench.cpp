@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+namespace {
+// what CHECK_RD costs on every call that starts with a clean rd
+void BM_CheckRdClean(benchmark::State &state) {
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ydb_check_rd_status(rd, __func__));
+  }
+  ydb_result_details_free(rd);
+}
+BENCHMARK(BM_CheckRdClean);
+
+// state.range(0): 1 for a codes-only rd, 0 for full messages
+void BM_ResultDetailsFail(benchmark::State &state) {
+  YdbResultDetails *rd = ydb_result_details_create(state.range(0));
+  for (auto _ : state) {
+    ydb_result_details_reset(rd);
+    benchmark::DoNotOptimize(ydb_result_details_fail(
+        rd, YDB_ERR_BAD_REQUEST, "column index out of range"));
+  }
+  ydb_result_details_free(rd);
+}
+BENCHMARK(BM_ResultDetailsFail)->ArgName("codes_only")->Arg(0)->Arg(1);
+
+// fail followed by a CHECK_RD that appends to the trail and by reading the
+// formatted message back, as an error surfacing through two calls would
+void BM_ResultDetailsFailAndFormat(benchmark::State &state) {
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  for (auto _ : state) {
+    ydb_result_details_reset(rd);
+    ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                            "column index out of range");
+    benchmark::DoNotOptimize(ydb_check_rd_status(rd, __func__));
+    benchmark::DoNotOptimize(get_message(rd));
+  }
+  ydb_result_details_free(rd);
+}
+BENCHMARK(BM_ResultDetailsFailAndFormat);
+
+void BM_ResultDetailsFailNull(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ydb_result_details_fail(
+        nullptr, YDB_ERR_BAD_REQUEST, "column index out of range"));
+  }
+}
+BENCHMARK(BM_ResultDetailsFailNull);
+} // namespace
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+void BM_ParamsScalar(benchmark::State &state) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  int64_t i = 0;
+  for (auto _ : state) {
+    ydb_params_set_int64(p, "$id", ++i, nullptr);
+    ydb_params_set_utf8(p, "$name", "alice", nullptr);
+    ydb_params_set_double(p, "$score", 0.5, nullptr);
+    benchmark::DoNotOptimize(ydb_query_params_get(p));
+  }
+  state.SetItemsProcessed(state.iterations() * 3);
+  ydb_query_params_free(p, nullptr);
+}
+BENCHMARK(BM_ParamsScalar);
+
+// List<Struct<id, name>> member by member through the builder
+void BM_ParamsStructListBuilder(benchmark::State &state) {
+  const auto rows = static_cast<int64_t>(state.range(0));
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  for (auto _ : state) {
+    YdbParamBuilder *b = ydb_params_begin_param(p, "$rows", nullptr);
+    ydb_params_begin_list(b, nullptr);
+    for (int64_t r = 0; r < rows; ++r) {
+      ydb_params_add_list_item(b, nullptr);
+      ydb_params_begin_struct(b, nullptr);
+      ydb_params_add_member_int64(b, "id", r, nullptr);
+      ydb_params_add_member_utf8(b, "name", "alice", nullptr);
+      ydb_params_end_struct(b, nullptr);
+    }
+    ydb_params_end_list(b, nullptr);
+    ydb_params_end_param(b, nullptr);
+    benchmark::DoNotOptimize(ydb_query_params_get(p));
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+  ydb_query_params_free(p, nullptr);
+}
+BENCHMARK(BM_ParamsStructListBuilder)->Arg(1)->Arg(100)->Arg(10000);
+
+// the same list from column arrays
+void BM_ParamsStructListColumns(benchmark::State &state) {
+  const auto rows = static_cast<size_t>(state.range(0));
+  std::vector<int64_t> ids(rows);
+  std::string names;
+  std::vector<uint32_t> offsets{0};
+  for (size_t r = 0; r < rows; ++r) {
+    ids[r] = static_cast<int64_t>(r);
+    names += "alice";
+    offsets.push_back(static_cast<uint32_t>(names.size()));
+  }
+  const YdbColumnBinding cols[] = {
+      {"id", YDB_TYPE_INT64, ids.data(), nullptr, nullptr},
+      {"name", YDB_TYPE_UTF8, names.data(), offsets.data(), nullptr},
+  };
+
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  for (auto _ : state) {
+    YdbParamBuilder *b = ydb_params_begin_param(p, "$rows", nullptr);
+    ydb_params_bind_struct_list(b, rows, 2, cols, nullptr);
+    ydb_params_end_param(b, nullptr);
+    benchmark::DoNotOptimize(ydb_query_params_get(p));
+  }
+  state.SetItemsProcessed(state.iterations() * rows);
+  ydb_query_params_free(p, nullptr);
+}
+BENCHMARK(BM_ParamsStructListColumns)->Arg(1)->Arg(100)->Arg(10000);
+} // namespace
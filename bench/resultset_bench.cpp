@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <ydb-cpp-sdk/client/proto/accessor.h>
+
+#include <src/api/protos/ydb_value.pb.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+constexpr int kColumns = 4;
+
+// columns: id Int64, name Utf8, score Double, note Optional<Utf8>
+Ydb::ResultSet MakeProto(int64_t rows) {
+  Ydb::ResultSet proto;
+  auto add_column = [&](const char *name, Ydb::Type::PrimitiveTypeId type,
+                        bool optional) {
+    auto *column = proto.add_columns();
+    column->set_name(name);
+    auto *t = column->mutable_type();
+    if (optional) {
+      t = t->mutable_optional_type()->mutable_item();
+    }
+    t->set_type_id(type);
+  };
+  add_column("id", Ydb::Type::INT64, false);
+  add_column("name", Ydb::Type::UTF8, false);
+  add_column("score", Ydb::Type::DOUBLE, false);
+  add_column("note", Ydb::Type::UTF8, true);
+
+  for (int64_t r = 0; r < rows; ++r) {
+    auto *row = proto.add_rows();
+    row->add_items()->set_int64_value(r);
+    row->add_items()->set_text_value("alice");
+    row->add_items()->set_double_value(0.5);
+    if (r % 2) {
+      row->add_items()->set_null_flag_value(google::protobuf::NULL_VALUE);
+    } else {
+      row->add_items()->set_text_value("note");
+    }
+  }
+  return proto;
+}
+
+// what every execute pays per set: the response proto moved into a
+// TResultSet and that into a YdbResultSet; the proto copy feeding each
+// iteration is not timed
+void BM_ResultSetConstruct(benchmark::State &state) {
+  const Ydb::ResultSet base = MakeProto(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Ydb::ResultSet proto = base;
+    state.ResumeTiming();
+    auto *rs = new YdbResultSet(NYdb::TResultSet(std::move(proto)));
+    benchmark::DoNotOptimize(rs);
+    ydb_resultset_free(rs);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ResultSetConstruct)->Arg(0)->Arg(100)->Arg(10000);
+
+// the path every execute takes: the response sets wrapped into one
+// YdbResultSets, sharing each set's proto. mode 1 adds a bound arena reset
+// per iteration; mode 2 is the baseline that deep-copies every proto first
+void BM_CollectLargeResult(benchmark::State &state) {
+  constexpr int kSets = 3;
+  const std::vector<NYdb::TResultSet> sets(
+      kSets, NYdb::TResultSet(MakeProto(state.range(0))));
+  YdbArena *arena =
+      state.range(1) == 1 ? ydb_arena_create(0, nullptr) : nullptr;
+  ydb_arena_bind(arena);
+  for (auto _ : state) {
+    std::vector<NYdb::TResultSet> copies;
+    if (state.range(1) == 2) {
+      copies.reserve(kSets);
+      for (const auto &set : sets) {
+        copies.emplace_back(
+            Ydb::ResultSet(NYdb::TProtoAccessor::GetProto(set)));
+      }
+    }
+    auto collected =
+        ydb_collect_result_sets(copies.empty() ? sets : copies, nullptr);
+    benchmark::DoNotOptimize(collected.get());
+    collected.reset();
+    ydb_arena_reset(arena);
+  }
+  ydb_arena_bind(nullptr);
+  ydb_arena_free(arena);
+  state.SetItemsProcessed(state.iterations() * kSets * state.range(0));
+}
+BENCHMARK(BM_CollectLargeResult)
+    ->ArgNames({"rows", "mode"})
+    ->Args({100000, 0})
+    ->Args({100000, 1})
+    ->Args({100000, 2});
+
+// each iteration also wraps a shared (refcounted) copy of the set
+void BM_ResultSetGetters(benchmark::State &state) {
+  const int64_t rows = state.range(0);
+  const NYdb::TResultSet base(MakeProto(rows));
+  for (auto _ : state) {
+    auto *rs = new YdbResultSet(base);
+    while (ydb_resultset_next_row(rs, nullptr)) {
+      int64_t id = 0;
+      const char *name = nullptr;
+      size_t name_len = 0;
+      double score = 0;
+      ydb_resultset_get_int64(rs, 0, &id, nullptr);
+      ydb_resultset_get_utf8(rs, 1, &name, &name_len, nullptr);
+      ydb_resultset_get_double(rs, 2, &score, nullptr);
+      if (!ydb_resultset_is_null(rs, 3, nullptr)) {
+        const char *note = nullptr;
+        size_t note_len = 0;
+        ydb_resultset_get_utf8(rs, 3, &note, &note_len, nullptr);
+        benchmark::DoNotOptimize(note);
+      }
+      benchmark::DoNotOptimize(id);
+      benchmark::DoNotOptimize(name);
+      benchmark::DoNotOptimize(score);
+    }
+    ydb_resultset_free(rs);
+  }
+  state.SetItemsProcessed(state.iterations() * rows * kColumns);
+}
+BENCHMARK(BM_ResultSetGetters)->Arg(100)->Arg(10000);
+
+// the same rows through ydb_resultset_fetch_columns, 1024 at a time
+void BM_ResultSetFetchColumns(benchmark::State &state) {
+  constexpr size_t kBatch = 1024;
+  const int64_t rows = state.range(0);
+  const NYdb::TResultSet base(MakeProto(rows));
+
+  std::vector<int64_t> ids(kBatch);
+  std::vector<double> scores(kBatch);
+  std::vector<char> names(kBatch * 8), notes(kBatch * 8);
+  std::vector<uint32_t> name_offsets(kBatch + 1), note_offsets(kBatch + 1);
+  std::vector<uint8_t> note_validity((kBatch + 7) / 8);
+
+  for (auto _ : state) {
+    auto *rs = new YdbResultSet(base);
+    YdbColumnBuffer cols[kColumns] = {};
+    size_t fetched = 0;
+    do {
+      cols[0].values = ids.data();
+      cols[1].values = names.data();
+      cols[1].data_capacity = names.size();
+      cols[1].offsets = name_offsets.data();
+      cols[2].values = scores.data();
+      cols[3].values = notes.data();
+      cols[3].data_capacity = notes.size();
+      cols[3].offsets = note_offsets.data();
+      cols[3].validity = note_validity.data();
+      if (ydb_resultset_fetch_columns(rs, kBatch, cols, &fetched, nullptr) !=
+          YDB_OK) {
+        state.SkipWithError("fetch_columns failed");
+        break;
+      }
+      benchmark::DoNotOptimize(ids.data());
+    } while (fetched == kBatch);
+    ydb_resultset_free(rs);
+  }
+  state.SetItemsProcessed(state.iterations() * rows * kColumns);
+}
+BENCHMARK(BM_ResultSetFetchColumns)->Arg(100)->Arg(10000);
+} // namespace
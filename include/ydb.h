@@ -32,9 +32,56 @@ typedef enum ydb_error_t {
   YDB_ERR_BUFFER_TOO_SMALL = -7,
   YDB_ERR_NO_MORE_RESULTS = -8,
   YDB_ERR_ALREADY_DONE = -9,
-  YDB_ERR_RETRY_FAILED = -10
+  YDB_ERR_RETRY_FAILED = -10,
+  YDB_ERR_WOULD_BLOCK = -11,
+  YDB_ERR_CANCELLED = -12,
+  YDB_ERR_UNAUTHORIZED = -13, // bad or missing credentials, never retried
+  YDB_ERR_RESOURCE_EXHAUSTED = -14 // a binding limit is full, not retried
 } ydb_error_t;
 
+typedef enum {
+  YDB_LOG_DEBUG = 0,
+  YDB_LOG_INFO = 1,
+  YDB_LOG_WARN = 2, // failures that are worth retrying
+  YDB_LOG_ERROR = 3,
+  YDB_LOG_OFF = 4,
+} ydb_log_level_t;
+
+typedef struct YdbErrorLogger YdbErrorLogger;
+
+typedef void (*ydb_log_callback_t)(ydb_log_level_t level, ydb_status_t code,
+                                   const char *message, void *user_data);
+
+// Nothing is logged until a logger is installed. Records below the level,
+// above the rate limit, or arriving while the ring buffer is being drained
+// are dropped rather than waited for.
+YdbErrorLogger *ydb_error_logger_create(ydb_log_level_t level,
+                                        YdbResultDetails *rd);
+// cb runs on the failing thread; message is only valid during the call.
+// The setters are safe on an installed logger; a log call already running
+// may still finish with the previous callback
+ydb_status_t ydb_error_logger_set_callback(YdbErrorLogger *logger,
+                                           ydb_log_callback_t cb,
+                                           void *user_data,
+                                           YdbResultDetails *rd);
+// keeps the last `capacity` records in memory for ydb_error_logger_drain
+ydb_status_t ydb_error_logger_set_ring_buffer(YdbErrorLogger *logger,
+                                              uint32_t capacity,
+                                              YdbResultDetails *rd);
+// 0 means unlimited
+ydb_status_t ydb_error_logger_set_rate_limit(YdbErrorLogger *logger,
+                                             uint32_t max_per_second,
+                                             YdbResultDetails *rd);
+// replays buffered records oldest first and empties the buffer
+size_t ydb_error_logger_drain(YdbErrorLogger *logger, ydb_log_callback_t cb,
+                              void *user_data);
+uint64_t ydb_error_logger_dropped(const YdbErrorLogger *logger);
+// process-wide; NULL uninstalls. Configure the logger before installing it
+void ydb_error_logger_install(YdbErrorLogger *logger);
+// uninstalls the logger and waits for log calls already using it, so the
+// callback's user_data can be released afterwards; never call it from cb
+void ydb_error_logger_free(YdbErrorLogger *logger);
+
 typedef enum ydb_type_t {
   YDB_TYPE_BOOL = 0x0006,
   YDB_TYPE_INT8 = 0x0007,
@@ -56,6 +103,7 @@ typedef enum ydb_type_t {
   YDB_TYPE_JSON = 0x1202,
   YDB_TYPE_UUID = 0x1203,
   YDB_TYPE_JSON_DOC = 0x1204,
+  YDB_TYPE_DECIMAL = 0x10000, // not a primitive id, see YdbColumnInfo
   YDB_TYPE_OPTIONAL = 0x0100,
   YDB_TYPE_UNKNOWN = 0x0000,
 } ydb_type_t;
@@ -73,9 +121,44 @@ typedef struct YdbRow YdbRow;
 typedef struct YdbValue YdbValue;
 typedef struct YdbQueryParams YdbQueryParams;
 typedef struct YdbParamBuilder YdbParamBuilder;
-typedef struct YdbErrorLogger YdbErrorLogger;
 typedef struct YdbQueryRetrySettings YdbQueryRetrySettings;
 typedef struct YdbResultDetails YdbResultDetails;
+typedef struct YdbQueryFuture YdbQueryFuture;
+typedef struct YdbExecSettings YdbExecSettings;
+typedef struct YdbMetricsSnapshot YdbMetricsSnapshot;
+typedef struct YdbPreparedQuery YdbPreparedQuery;
+typedef struct YdbResultStream YdbResultStream;
+typedef struct YdbArena YdbArena;
+typedef struct YdbEndpointList YdbEndpointList;
+typedef struct YdbTopicClient YdbTopicClient;
+typedef struct YdbTopicWriterConfig YdbTopicWriterConfig;
+typedef struct YdbTopicWriter YdbTopicWriter;
+typedef struct YdbTopicReaderConfig YdbTopicReaderConfig;
+typedef struct YdbTopicReader YdbTopicReader;
+typedef struct YdbTopicBatch YdbTopicBatch;
+
+/* ============================================================
+ * Thread Safety
+ * ============================================================ */
+// Shared: YdbDriver, YdbQueryClient, YdbTableClient, YdbTopicClient and
+// YdbPreparedQuery may be used from any number of threads at once, with no
+// lock held across a call. ydb_driver_set_tracer and
+// ydb_query_client_set_exec_settings swap a snapshot atomically; calls
+// already running finish with the old one. Metrics, error logging and the
+// per-thread state below take no locks on the call path.
+//
+// Thread-confined: YdbResultDetails, YdbQueryParams, YdbParamBuilder,
+// YdbQueryTransaction, YdbSession, YdbResultSets, YdbResultSet,
+// YdbResultStream, YdbQueryFuture, topic writers, readers and batches, and
+// every config object. Use each from one thread at a time; handing one to
+// another thread needs the caller's own synchronization. A YdbQueryFuture
+// may be cancelled from any thread.
+//
+// Per-thread: ydb_result_details_thread_local, ydb_query_last_stats,
+// ydb_trace_set_parent and the current arena belong to the calling thread.
+//
+// Freeing a shared handle must not race with calls on it, and a driver
+// outlives its clients.
 
 /* ============================================================
  * Driver Configuration & Lifecycle
@@ -92,20 +175,110 @@ ydb_status_t ydb_driver_config_set_database(YdbDriverConfig *cfg,
 ydb_status_t ydb_driver_config_set_auth_token(YdbDriverConfig *cfg,
                                               const char *token,
                                               YdbResultDetails *rd);
-/* Future: ydb_driver_config_set_tls_cert, _set_connection_pool_size, etc. */
+// 0 for either bound keeps the SDK default; min may not exceed the
+// effective max, the SDK default included
+ydb_status_t ydb_driver_config_set_session_pool_size(YdbDriverConfig *cfg,
+                                                     uint32_t min_sessions,
+                                                     uint32_t max_sessions,
+                                                     YdbResultDetails *rd);
+// idle sessions above the pool minimum are closed after idle_timeout_ms
+ydb_status_t ydb_driver_config_set_session_idle_timeout(YdbDriverConfig *cfg,
+                                                        uint32_t idle_timeout_ms,
+                                                        YdbResultDetails *rd);
+// 0 keeps the SDK default for any of the sizes below
+ydb_status_t ydb_driver_config_set_thread_pools(YdbDriverConfig *cfg,
+                                                uint32_t network_threads,
+                                                uint32_t client_threads,
+                                                YdbResultDetails *rd);
+// pending callbacks on the client pool before new requests are rejected
+ydb_status_t ydb_driver_config_set_max_client_queue_size(YdbDriverConfig *cfg,
+                                                         uint32_t size,
+                                                         YdbResultDetails *rd);
+ydb_status_t ydb_driver_config_set_grpc_keepalive(YdbDriverConfig *cfg,
+                                                  uint32_t timeout_ms,
+                                                  int permit_without_calls,
+                                                  YdbResultDetails *rd);
+ydb_status_t ydb_driver_config_set_max_message_size(YdbDriverConfig *cfg,
+                                                    uint64_t inbound_bytes,
+                                                    uint64_t outbound_bytes,
+                                                    YdbResultDetails *rd);
+
+typedef enum {
+  YDB_DISCOVERY_SYNC = 1,  // driver creation waits for the first discovery
+  YDB_DISCOVERY_ASYNC = 2, // first requests go to the initial endpoint
+  YDB_DISCOVERY_OFF = 3,   // always use the initial endpoint
+} ydb_discovery_mode_t;
+
+ydb_status_t ydb_driver_config_set_discovery_mode(YdbDriverConfig *cfg,
+                                                  ydb_discovery_mode_t mode,
+                                                  YdbResultDetails *rd);
+// sessions ydb_driver_start opens in the background, 1 by default
+ydb_status_t ydb_driver_config_set_warm_sessions(YdbDriverConfig *cfg,
+                                                 uint32_t sessions,
+                                                 YdbResultDetails *rd);
+
+typedef enum {
+  YDB_BALANCING_DEFAULT = 0,
+  YDB_BALANCING_PREFER_LOCATION = 1,     // location NULL means the local DC
+  YDB_BALANCING_PREFER_PRIMARY_PILE = 2,
+  YDB_BALANCING_ALL_NODES = 3,           // random choice over every node
+} ydb_balancing_policy_t;
+
+ydb_status_t ydb_driver_config_set_balancing_policy(
+    YdbDriverConfig *cfg, ydb_balancing_policy_t policy, const char *location,
+    YdbResultDetails *rd);
+/* Future: ydb_driver_config_set_tls_cert, etc. */
 
 YdbDriver *ydb_driver_create(const YdbDriverConfig *cfg, YdbResultDetails *rd);
 void ydb_driver_free(YdbDriver *drv); /* blocks until closed */
-ydb_status_t ydb_driver_start(YdbDriver *drv,
-                              YdbResultDetails *rd); /* non-blocking init */
+// non-blocking: starts opening the warm sessions, which then stay idle in
+// the pool shared by every query client of this driver
+ydb_status_t ydb_driver_start(YdbDriver *drv, YdbResultDetails *rd);
+// blocks until a session has been created; calls ydb_driver_start if needed.
+// On timeout returns the last session creation failure, if there was one,
+// and YDB_ERR_TIMEOUT otherwise
 ydb_status_t ydb_driver_wait_ready(YdbDriver *drv, uint32_t timeout_ms,
                                    YdbResultDetails *rd);
 
+typedef struct YdbEndpointInfo {
+  const char *address;
+  uint32_t port;
+  const char *location;
+  uint32_t node_id;
+  float load_factor;
+} YdbEndpointInfo;
+
+// runs discovery now; *out_items stays valid until the list is freed
+ydb_status_t ydb_driver_list_endpoints(YdbDriver *drv,
+                                       YdbEndpointList **out_list,
+                                       const YdbEndpointInfo **out_items,
+                                       size_t *out_count,
+                                       YdbResultDetails *rd);
+void ydb_endpoint_list_free(YdbEndpointList *list);
+
+/* ============================================================
+ * Arenas
+ * ============================================================ */
+// While an arena is bound to a thread, result sets, result set lists and
+// param builders created on that thread come from it. Their free calls
+// become no-ops and ydb_arena_reset releases them all at once, so nothing
+// from the arena may be used after the reset. Data owned by the SDK
+// (the parsed rows, built values) is still heap allocated.
+YdbArena *ydb_arena_create(size_t initial_size, YdbResultDetails *rd);
+// NULL unbinds; returns the arena that was bound before
+YdbArena *ydb_arena_bind(YdbArena *arena);
+void ydb_arena_reset(YdbArena *arena);
+void ydb_arena_free(YdbArena *arena);
+
 /* ============================================================
  * Query Parameters (for parameterized queries)
  * ============================================================ */
 YdbQueryParams *ydb_query_params_create(YdbResultDetails *rd);
 void ydb_query_params_free(YdbQueryParams *params, YdbResultDetails *rd);
+// drops every value but keeps the declared names, so the same object can be
+// refilled for the next execute; params are never consumed by execute
+ydb_status_t ydb_query_params_reset(YdbQueryParams *params,
+                                    YdbResultDetails *rd);
 
 YdbParamBuilder *ydb_params_begin_param(YdbQueryParams *p, const char *name,
                                         YdbResultDetails *rd);
@@ -160,9 +333,34 @@ ydb_status_t ydb_params_add_member_bytes(YdbParamBuilder *b, const char *field,
 ydb_status_t ydb_params_add_member_null(YdbParamBuilder *b, const char *field,
                                         YdbResultDetails *rd);
 
+/* ============================================================
+ * Columnar Bulk Binding
+ * ============================================================ */
+typedef struct YdbColumnBinding {
+  const char *name;
+  // BOOL, INT32, UINT32, INT64, UINT64, FLOAT, DOUBLE, UTF8 or BYTES
+  ydb_type_t type;
+  // n_rows values (uint8_t per row for BOOL), or the string data
+  const void *values;
+  // UTF8/BYTES only: n_rows + 1 offsets into values
+  const uint32_t *offsets;
+  // optional, bit i set means row i is not NULL; makes the member Optional
+  const uint8_t *validity;
+} YdbColumnBinding;
+
+// builds List<Struct<...>> with one member per column in a single pass;
+// use between ydb_params_begin_param and ydb_params_end_param
+ydb_status_t ydb_params_bind_struct_list(YdbParamBuilder *b, size_t n_rows,
+                                         size_t n_cols,
+                                         const YdbColumnBinding *cols,
+                                         YdbResultDetails *rd);
+
 /* ============================================================
  * Scalar Parameters
  * ============================================================ */
+// setting an existing name overwrites its value; the next execute rebuilds
+// the whole parameter set once, however many values changed, so batch the
+// sets for a statement before running it rather than interleaving them
 ydb_status_t ydb_params_set_utf8(YdbQueryParams *p, const char *name,
                                  const char *value, YdbResultDetails *rd);
 ydb_status_t ydb_params_set_int64(YdbQueryParams *p, const char *name,
@@ -189,6 +387,119 @@ typedef enum {
   YDB_TX_NONE = 6,
 } ydb_tx_mode_t;
 
+/* ============================================================
+ * Table Service
+ * ============================================================ */
+YdbTableClient *ydb_table_client_create(YdbDriver *drv, YdbResultDetails *rd);
+void ydb_table_client_free(YdbTableClient *tc);
+
+// writes the List<Struct<...>> parameter `param_name` of `rows` straight to
+// the table, bypassing the query processor and transactions; `rows` is left
+// unchanged, so a failed upsert can be retried with the same parameters
+ydb_status_t ydb_table_bulk_upsert(YdbTableClient *tc, const char *table_path,
+                                   YdbQueryParams *rows,
+                                   const char *param_name,
+                                   YdbResultDetails *rd);
+
+/* ============================================================
+ * Topic Service
+ * ============================================================ */
+YdbTopicClient *ydb_topic_client_create(YdbDriver *drv, YdbResultDetails *rd);
+void ydb_topic_client_free(YdbTopicClient *tc);
+
+typedef enum {
+  YDB_TOPIC_CODEC_RAW = 1,
+  YDB_TOPIC_CODEC_GZIP = 2,
+  YDB_TOPIC_CODEC_ZSTD = 4,
+} ydb_topic_codec_t;
+
+typedef enum {
+  YDB_TOPIC_ACK_WRITTEN = 1,
+  YDB_TOPIC_ACK_ALREADY_WRITTEN = 2,
+  YDB_TOPIC_ACK_DISCARDED = 3,
+} ydb_topic_ack_state_t;
+
+// runs on an SDK thread once the server has persisted the message
+typedef void (*ydb_topic_ack_callback_t)(uint64_t seq_no,
+                                         ydb_topic_ack_state_t state,
+                                         void *user_data);
+
+YdbTopicWriterConfig *ydb_topic_writer_config_create(const char *topic_path,
+                                                     YdbResultDetails *rd);
+void ydb_topic_writer_config_free(YdbTopicWriterConfig *cfg);
+ydb_status_t ydb_topic_writer_config_set_producer_id(YdbTopicWriterConfig *cfg,
+                                                     const char *producer_id,
+                                                     YdbResultDetails *rd);
+ydb_status_t ydb_topic_writer_config_set_codec(YdbTopicWriterConfig *cfg,
+                                               ydb_topic_codec_t codec,
+                                               YdbResultDetails *rd);
+// writes are refused with YDB_ERR_WOULD_BLOCK once unacked data exceeds
+// max_bytes or max_messages; 0 keeps the SDK default
+ydb_status_t ydb_topic_writer_config_set_inflight_limit(
+    YdbTopicWriterConfig *cfg, uint64_t max_bytes, uint32_t max_messages,
+    YdbResultDetails *rd);
+// a batch is sent after linger_ms or once it holds batch_bytes
+ydb_status_t ydb_topic_writer_config_set_batching(YdbTopicWriterConfig *cfg,
+                                                  uint32_t linger_ms,
+                                                  uint64_t batch_bytes,
+                                                  YdbResultDetails *rd);
+ydb_status_t ydb_topic_writer_config_set_ack_callback(
+    YdbTopicWriterConfig *cfg, ydb_topic_ack_callback_t cb, void *user_data,
+    YdbResultDetails *rd);
+
+YdbTopicWriter *ydb_topic_writer_create(YdbTopicClient *tc,
+                                        const YdbTopicWriterConfig *cfg,
+                                        YdbResultDetails *rd);
+// never blocks; data is copied. seq_no 0 lets the SDK number the message.
+// YDB_ERR_WOULD_BLOCK while the in-flight limit is reached
+ydb_status_t ydb_topic_writer_write(YdbTopicWriter *w, const void *data,
+                                    size_t len, uint64_t seq_no,
+                                    YdbResultDetails *rd);
+// waits up to timeout_ms until a write would be accepted: YDB_OK, the
+// close status if the session ended, or YDB_ERR_TIMEOUT. Another thread
+// writing in between can still take the slot, so write may again return
+// YDB_ERR_WOULD_BLOCK
+ydb_status_t ydb_topic_writer_wait_ready(YdbTopicWriter *w,
+                                         uint32_t timeout_ms,
+                                         YdbResultDetails *rd);
+// waits up to timeout_ms for in-flight messages to be acked
+ydb_status_t ydb_topic_writer_close(YdbTopicWriter *w, uint32_t timeout_ms,
+                                    YdbResultDetails *rd);
+void ydb_topic_writer_free(YdbTopicWriter *w);
+
+YdbTopicReaderConfig *ydb_topic_reader_config_create(const char *topic_path,
+                                                     const char *consumer,
+                                                     YdbResultDetails *rd);
+void ydb_topic_reader_config_free(YdbTopicReaderConfig *cfg);
+ydb_status_t ydb_topic_reader_config_set_max_memory(YdbTopicReaderConfig *cfg,
+                                                    uint64_t max_bytes,
+                                                    YdbResultDetails *rd);
+
+YdbTopicReader *ydb_topic_reader_create(YdbTopicClient *tc,
+                                        const YdbTopicReaderConfig *cfg,
+                                        YdbResultDetails *rd);
+// waits up to timeout_ms for data and returns every message available, up to
+// about max_bytes; YDB_ERR_TIMEOUT if nothing arrived
+ydb_status_t ydb_topic_reader_read_batch(YdbTopicReader *r,
+                                         uint32_t timeout_ms, size_t max_bytes,
+                                         YdbTopicBatch **out,
+                                         YdbResultDetails *rd);
+void ydb_topic_reader_free(YdbTopicReader *r);
+
+typedef struct YdbTopicMessage {
+  const void *data; // valid until the batch is freed
+  size_t len;
+  uint64_t offset;
+  uint64_t seq_no;
+  int64_t partition_id;
+} YdbTopicMessage;
+
+size_t ydb_topic_batch_size(const YdbTopicBatch *b);
+const YdbTopicMessage *ydb_topic_batch_messages(const YdbTopicBatch *b);
+// commits the offsets of every message in the batch
+ydb_status_t ydb_topic_batch_commit(YdbTopicBatch *b, YdbResultDetails *rd);
+void ydb_topic_batch_free(YdbTopicBatch *b);
+
 /* ============================================================
  * Query Service
  * ============================================================ */
@@ -200,30 +511,246 @@ YdbQueryRetrySettings *ydb_query_retry_settings_create(uint32_t max_retries,
                                                        YdbResultDetails *rd);
 void ydb_query_retry_settings_free(YdbQueryRetrySettings *rs,
                                    YdbResultDetails *rd);
+// ABORTED, SESSION_BUSY, UNAVAILABLE and transport errors use the fast
+// class, OVERLOADED and CLIENT_RESOURCE_EXHAUSTED the slow one; both start
+// as a constant timeout_ms delay
+ydb_status_t ydb_query_retry_settings_set_fast_backoff(YdbQueryRetrySettings *rs,
+                                                      uint32_t slot_ms,
+                                                      uint32_t ceiling,
+                                                      YdbResultDetails *rd);
+ydb_status_t ydb_query_retry_settings_set_slow_backoff(YdbQueryRetrySettings *rs,
+                                                      uint32_t slot_ms,
+                                                      uint32_t ceiling,
+                                                      YdbResultDetails *rd);
+// caps every backoff delay; ydb_query_execute_with_retry gets it as a
+// smaller slot and ceiling, since the SDK loop has no separate cap
+ydb_status_t ydb_query_retry_settings_set_max_backoff(YdbQueryRetrySettings *rs,
+                                                     uint32_t max_backoff_ms,
+                                                     YdbResultDetails *rd);
+// share of every delay that is randomized, 0 disables jitter
+ydb_status_t ydb_query_retry_settings_set_jitter(YdbQueryRetrySettings *rs,
+                                                double ratio,
+                                                YdbResultDetails *rd);
+// total budget measured from create/reset, 0 disables it
+ydb_status_t ydb_query_retry_settings_set_deadline(YdbQueryRetrySettings *rs,
+                                                  uint32_t deadline_ms,
+                                                  YdbResultDetails *rd);
+// allows ydb_query_execute_with_retry to retry statuses with unknown outcome
+ydb_status_t ydb_query_retry_settings_set_idempotent(YdbQueryRetrySettings *rs,
+                                                    int idempotent,
+                                                    YdbResultDetails *rd);
+void ydb_query_retry_settings_reset(YdbQueryRetrySettings *rs);
+
+// same checks as ydb_query_perform_retry, but returns the delay instead of
+// sleeping, for callers that reschedule on their own event loop
+ydb_status_t ydb_query_retry_next_delay(YdbQueryRetrySettings *rs,
+                                        uint64_t *out_delay_us,
+                                        YdbResultDetails *rd);
 ydb_status_t ydb_query_perform_retry(YdbQueryRetrySettings *rs,
                                      YdbResultDetails *rd);
 
+// runs the whole retry loop inside the SDK; with a tx mode other than
+// YDB_TX_NONE each attempt begins and commits its own transaction.
+// rs may be NULL for SDK defaults
+ydb_status_t ydb_query_execute_with_retry(YdbQueryClient *qc, const char *yql,
+                                          const YdbQueryParams *params,
+                                          ydb_tx_mode_t tx_mode,
+                                          YdbQueryRetrySettings *rs,
+                                          YdbResultSets **out_results,
+                                          YdbResultDetails *rd);
+
 // for DDL commands
 ydb_status_t ydb_query_NOtx_execute(YdbQueryClient *qc, const char *yql,
                                     const YdbQueryParams *params,
                                     YdbResultSets **out_results,
                                     YdbResultDetails *result_details);
 
+// the handle is owned by qc and stays valid until it is unprepared or the
+// client is freed; preparing the same text again returns the same handle.
+// Once the cache holds the limit (1024 by default, see
+// ydb_query_client_set_prepared_limit) new text fails with
+// YDB_ERR_RESOURCE_EXHAUSTED until a handle is unprepared. Handles only
+// execute on qc and on transactions begun from it
+ydb_status_t ydb_query_prepare(YdbQueryClient *qc, const char *yql,
+                               YdbPreparedQuery **out_query,
+                               YdbResultDetails *rd);
+// pq must not be in use on any thread
+ydb_status_t ydb_query_unprepare(YdbQueryClient *qc, YdbPreparedQuery *pq,
+                                 YdbResultDetails *rd);
+ydb_status_t ydb_query_client_set_prepared_limit(YdbQueryClient *qc,
+                                                 size_t limit,
+                                                 YdbResultDetails *rd);
+ydb_status_t ydb_query_execute_prepared(YdbQueryClient *qc,
+                                        const YdbPreparedQuery *pq,
+                                        const YdbQueryParams *params,
+                                        YdbResultSets **out_results,
+                                        YdbResultDetails *rd);
+
 ydb_status_t ydb_query_begin_tx(YdbQueryClient *, ydb_tx_mode_t,
                                 YdbQueryTransaction **, YdbResultDetails *rd);
+// no BeginTransaction round trip: the first execute begins the transaction
+// inline, so begin_tx_lazy + tx_execute_commit is a single ExecuteQuery
+ydb_status_t ydb_query_begin_tx_lazy(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
+                                     YdbQueryTransaction **out_tx,
+                                     YdbResultDetails *rd);
 ydb_status_t ydb_query_tx_execute(YdbQueryTransaction *, const char *,
                                   const YdbQueryParams *, YdbResultSets **,
                                   YdbResultDetails *rd);
+ydb_status_t ydb_query_tx_execute_prepared(YdbQueryTransaction *tx,
+                                           const YdbPreparedQuery *pq,
+                                           const YdbQueryParams *params,
+                                           YdbResultSets **out_results,
+                                           YdbResultDetails *rd);
+// commits together with the statement; further calls on the transaction
+// fail with YDB_ERR_ALREADY_DONE
+ydb_status_t ydb_query_tx_execute_commit(YdbQueryTransaction *tx,
+                                         const char *yql,
+                                         const YdbQueryParams *params,
+                                         YdbResultSets **out_results,
+                                         YdbResultDetails *rd);
+ydb_status_t ydb_query_tx_execute_prepared_commit(YdbQueryTransaction *tx,
+                                                  const YdbPreparedQuery *pq,
+                                                  const YdbQueryParams *params,
+                                                  YdbResultSets **out_results,
+                                                  YdbResultDetails *rd);
 ydb_status_t ydb_query_tx_commit(YdbQueryTransaction *, YdbResultDetails *rd);
+// a rolled back transaction refuses further executes with
+// YDB_ERR_ALREADY_DONE, lazy ones included
 ydb_status_t ydb_query_tx_rollback(YdbQueryTransaction *, YdbResultDetails *rd);
 void ydb_query_tx_free(YdbQueryTransaction *, YdbResultDetails *rd);
 
+/* ============================================================
+ * Execution Settings
+ * ============================================================ */
+typedef enum {
+  YDB_STATS_NONE = 0,
+  YDB_STATS_BASIC = 1,
+  YDB_STATS_FULL = 2,
+  YDB_STATS_PROFILE = 3,
+} ydb_stats_mode_t;
+
+YdbExecSettings *ydb_exec_settings_create(YdbResultDetails *rd);
+void ydb_exec_settings_free(YdbExecSettings *s);
+// sent as the gRPC deadline, so the server also drops the query once it
+// expires; 0 disables it
+ydb_status_t ydb_exec_settings_set_client_timeout(YdbExecSettings *s,
+                                                  uint32_t timeout_ms,
+                                                  YdbResultDetails *rd);
+ydb_status_t ydb_exec_settings_set_resource_pool(YdbExecSettings *s,
+                                                 const char *pool,
+                                                 YdbResultDetails *rd);
+ydb_status_t ydb_exec_settings_set_stats_mode(YdbExecSettings *s,
+                                              ydb_stats_mode_t mode,
+                                              YdbResultDetails *rd);
+
+typedef struct YdbQueryStats {
+  uint64_t total_duration_us; // server side
+  uint64_t total_cpu_us;
+  uint64_t rows_read;
+  uint64_t bytes_read;
+  uint64_t rows_affected; // updated plus deleted
+  uint64_t bytes_affected;
+  const char *plan; // JSON; NULL below YDB_STATS_FULL
+  const char *ast;
+} YdbQueryStats;
+
+// stats of the last query finished on the calling thread, valid until the
+// next query on it; YDB_ERR_NOT_FOUND if that query ran without a stats mode.
+// For async queries this is the thread that called ydb_query_future_get
+ydb_status_t ydb_query_last_stats(const YdbQueryStats **out,
+                                  YdbResultDetails *rd);
+
+// s is copied and applies to every execute, commit and rollback started
+// afterwards, including transactions and pinned sessions of qc; NULL
+// restores the defaults
+ydb_status_t ydb_query_client_set_exec_settings(YdbQueryClient *qc,
+                                                const YdbExecSettings *s,
+                                                YdbResultDetails *rd);
+// overrides the settings inherited from the client for this transaction
+ydb_status_t ydb_query_tx_set_exec_settings(YdbQueryTransaction *tx,
+                                            const YdbExecSettings *s,
+                                            YdbResultDetails *rd);
+
+/* ============================================================
+ * Pinned Sessions
+ * ============================================================ */
+// the session stays checked out of the pool until released; a session is
+// not safe for concurrent queries
+ydb_status_t ydb_query_session_acquire(YdbQueryClient *qc,
+                                       YdbSession **out_session,
+                                       YdbResultDetails *rd);
+void ydb_query_session_release(YdbSession *s, YdbResultDetails *rd);
+
+ydb_status_t ydb_query_session_execute(YdbSession *s, const char *yql,
+                                       const YdbQueryParams *params,
+                                       YdbResultSets **out_results,
+                                       YdbResultDetails *rd);
+ydb_status_t ydb_query_session_begin_tx(YdbSession *s, ydb_tx_mode_t tx_mode,
+                                        YdbQueryTransaction **out_tx,
+                                        YdbResultDetails *rd);
+
+/* ============================================================
+ * Asynchronous Query Execution
+ * ============================================================ */
+typedef void (*ydb_query_callback_t)(YdbQueryFuture *future, void *user_data);
+
+YdbQueryFuture *ydb_query_execute_async(YdbQueryClient *qc, const char *yql,
+                                        const YdbQueryParams *params,
+                                        YdbResultDetails *rd);
+// only one query may be in flight per transaction; a lazy transaction must
+// run its first statement synchronously
+YdbQueryFuture *ydb_query_tx_execute_async(YdbQueryTransaction *tx,
+                                           const char *yql,
+                                           const YdbQueryParams *params,
+                                           YdbResultDetails *rd);
+
+int ydb_query_future_is_ready(const YdbQueryFuture *f);
+// YDB_ERR_TIMEOUT if the query is still running after timeout_ms
+ydb_status_t ydb_query_future_wait(YdbQueryFuture *f, uint32_t timeout_ms,
+                                   YdbResultDetails *rd);
+// cb runs on an SDK thread, or right away if the future is already ready;
+// it is not called once the future is cancelled or freed
+ydb_status_t ydb_query_future_on_ready(YdbQueryFuture *f,
+                                       ydb_query_callback_t cb,
+                                       void *user_data, YdbResultDetails *rd);
+// blocks until ready; results can be taken only once
+ydb_status_t ydb_query_future_get(YdbQueryFuture *f,
+                                  YdbResultSets **out_results,
+                                  YdbResultDetails *rd);
+// stops waiting for the result: pending callbacks are dropped and
+// wait/get return YDB_ERR_CANCELLED. The request itself runs on until the
+// server answers or its client timeout expires
+ydb_status_t ydb_query_future_cancel(YdbQueryFuture *f, YdbResultDetails *rd);
+void ydb_query_future_free(YdbQueryFuture *f);
+
+/* ============================================================
+ * Streaming Results
+ * ============================================================ */
+// YDB_TX_NONE runs without a transaction, any other mode in a single
+// self-committing transaction
+ydb_status_t ydb_query_stream_execute(YdbQueryClient *qc, const char *yql,
+                                      const YdbQueryParams *params,
+                                      ydb_tx_mode_t tx_mode,
+                                      YdbResultStream **out_stream,
+                                      YdbResultDetails *rd);
+// blocks for the next chunk; one result set may arrive as several chunks
+// with the same index. YDB_ERR_NO_MORE_RESULTS once the stream is done,
+// without touching rd. Each chunk is freed with ydb_resultset_free
+ydb_status_t ydb_result_stream_next_part(YdbResultStream *stream,
+                                         YdbResultSet **out_set,
+                                         int64_t *out_index,
+                                         YdbResultDetails *rd);
+// cancels the query if it is still streaming
+void ydb_result_stream_free(YdbResultStream *stream);
+
 /* ============================================================
  * Result Iteration
  * ============================================================ */
 YdbResultSet *ydb_resultsets_release(YdbResultSets *rs, int index,
                                  YdbResultDetails *rd);
 void ydb_resultsets_free(YdbResultSets *rs, YdbResultDetails *rd);
+// frees a set taken with ydb_resultsets_release or ydb_result_stream_next_part
+void ydb_resultset_free(YdbResultSet *rs);
 
 int ydb_resultset_column_count(const YdbResultSet *rs, YdbResultDetails *rd);
 const char *ydb_resultset_column_name(const YdbResultSet *rs, int col_index,
@@ -231,24 +758,280 @@ const char *ydb_resultset_column_name(const YdbResultSet *rs, int col_index,
 ydb_type_t ydb_resultset_column_type(const YdbResultSet *rs, int col_index,
                                      YdbResultDetails *rd);
 
+typedef struct YdbColumnInfo {
+  const char *name;
+  ydb_type_t type; // Optional unwrapped, UNKNOWN for other containers
+  int nullable;
+  uint8_t decimal_precision; // DECIMAL only
+  uint8_t decimal_scale;
+} YdbColumnInfo;
+
+// computed once per result set; *out stays valid until rs is freed
+ydb_status_t ydb_resultset_schema(const YdbResultSet *rs,
+                                  const YdbColumnInfo **out, int *n,
+                                  YdbResultDetails *rd);
+
 int ydb_resultset_next_row(YdbResultSet *rs,
                            YdbResultDetails *rd); // 0 if done
 
+// Getters dispatch on the column type from the schema and work the same for
+// Optional and plain columns. A getter accepts any column whose values fit
+// its output without loss (get_int64 reads Int8..Int64 and Uint8..Uint32,
+// get_double reads Float); other types fail with YDB_ERR_BAD_REQUEST and
+// NULL with YDB_ERR_NOT_FOUND, leaving *out untouched.
+//
+// utf8/bytes getters return views into the result set that stay valid until
+// it is freed; they do not copy and do not invalidate each other. get_utf8
+// reads Utf8, Json and JsonDocument, get_bytes any string column
 ydb_status_t ydb_resultset_get_utf8(YdbResultSet *rs, int col, const char **out,
                                     size_t *out_len, YdbResultDetails *rd);
+ydb_status_t ydb_resultset_get_bytes(YdbResultSet *rs, int col,
+                                     const void **out, size_t *out_len,
+                                     YdbResultDetails *rd);
+ydb_status_t ydb_resultset_get_bool(YdbResultSet *rs, int col, int *out,
+                                    YdbResultDetails *rd);
+ydb_status_t ydb_resultset_get_int32(YdbResultSet *rs, int col, int32_t *out,
+                                     YdbResultDetails *rd);
+ydb_status_t ydb_resultset_get_uint32(YdbResultSet *rs, int col, uint32_t *out,
+                                      YdbResultDetails *rd);
 ydb_status_t ydb_resultset_get_int64(YdbResultSet *rs, int col, int64_t *out,
                                      YdbResultDetails *rd);
 ydb_status_t ydb_resultset_get_uint64(YdbResultSet *rs, int col, uint64_t *out,
                                       YdbResultDetails *rd);
+ydb_status_t ydb_resultset_get_float(YdbResultSet *rs, int col, float *out,
+                                     YdbResultDetails *rd);
 ydb_status_t ydb_resultset_get_double(YdbResultSet *rs, int col, double *out,
                                       YdbResultDetails *rd);
-ydb_status_t ydb_resultset_get_bool(YdbResultSet *rs, int col, int *out,
+// days since the epoch
+ydb_status_t ydb_resultset_get_date(YdbResultSet *rs, int col, uint32_t *out,
+                                    YdbResultDetails *rd);
+// seconds since the epoch
+ydb_status_t ydb_resultset_get_datetime(YdbResultSet *rs, int col,
+                                        uint32_t *out, YdbResultDetails *rd);
+// microseconds since the epoch
+ydb_status_t ydb_resultset_get_timestamp(YdbResultSet *rs, int col,
+                                         uint64_t *out, YdbResultDetails *rd);
+// microseconds
+ydb_status_t ydb_resultset_get_interval(YdbResultSet *rs, int col,
+                                        int64_t *out, YdbResultDetails *rd);
+// out holds 16 bytes in YDB's wire order, the low 64-bit half first
+ydb_status_t ydb_resultset_get_uuid(YdbResultSet *rs, int col, uint8_t *out,
                                     YdbResultDetails *rd);
-ydb_status_t ydb_resultset_get_bytes(YdbResultSet *rs, int col,
-                                     const void **out, size_t *out_len,
-                                     YdbResultDetails *rd);
 int ydb_resultset_is_null(YdbResultSet *rs, int col, YdbResultDetails *rd);
 
+struct YdbValue {
+  ydb_type_t type; // column type, Optional unwrapped
+  int is_null;     // value is zeroed when set
+  union {
+    int boolean;  // BOOL
+    int64_t i64;  // INT8..INT64, INTERVAL
+    uint64_t u64; // UINT8..UINT64, DATE, DATETIME, TIMESTAMP
+    float f32;    // FLOAT
+    double f64;   // DOUBLE
+    struct {
+      const char *data;
+      size_t len;
+    } str;            // UTF8, BYTES, JSON, JSON_DOC; same lifetime as getters
+    uint8_t uuid[16]; // UUID
+    struct {
+      uint64_t low; // unscaled value as a two's complement 128-bit integer
+      int64_t high;
+      uint8_t precision;
+      uint8_t scale;
+    } decimal; // DECIMAL
+  } value;
+};
+
+// any cell of the current row by its own type, with units as in the typed
+// getters; NULL is YDB_OK with is_null set. Fails with YDB_ERR_BAD_REQUEST
+// for containers and other types ydb_type_t does not list
+ydb_status_t ydb_resultset_get_value(YdbResultSet *rs, int col, YdbValue *out,
+                                     YdbResultDetails *rd);
+
+/* ============================================================
+ * Columnar Fetch
+ * ============================================================ */
+// One buffer per column, all sized for max_rows. Fixed-width values are
+// packed natively (BOOL as uint8_t, DATE as uint16_t days, DATETIME as
+// uint32_t seconds, TIMESTAMP as uint64_t and INTERVAL as int64_t micros).
+typedef struct YdbColumnBuffer {
+  // out: primitive type of the column, Optional unwrapped
+  ydb_type_t type;
+  // fixed-width values, or string data for UTF8/BYTES/JSON/JSON_DOC
+  void *values;
+  // string columns only: bytes available in values
+  size_t data_capacity;
+  // string columns only: room for max_rows + 1 offsets
+  uint32_t *offsets;
+  // (max_rows + 7) / 8 bytes, bit set means not NULL; required for
+  // nullable columns, filled with ones for the rest when given
+  uint8_t *validity;
+  // out: string bytes written, NULLs in the batch
+  size_t data_len;
+  size_t null_count;
+} YdbColumnBuffer;
+
+// decodes up to max_rows rows after the current one into out[column];
+// *rows_fetched is 0 at the end. A batch stops early when a string column
+// runs out of data_capacity; YDB_ERR_BUFFER_TOO_SMALL if not even one row fits
+ydb_status_t ydb_resultset_fetch_columns(YdbResultSet *rs, size_t max_rows,
+                                         YdbColumnBuffer *out,
+                                         size_t *rows_fetched,
+                                         YdbResultDetails *rd);
+
+/* ============================================================
+ * Arrow Export
+ * ============================================================ */
+// Arrow C Data Interface, https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+  int (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+  int (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+  const char *(*get_last_error)(struct ArrowArrayStream *);
+  void (*release)(struct ArrowArrayStream *);
+  void *private_data;
+};
+
+#endif /* ARROW_C_STREAM_INTERFACE */
+
+// exports the rows left in rs as one struct array (a record batch);
+// Date is date32, Datetime/Timestamp are timestamp[s]/[us], Interval is
+// duration[us], Json/JsonDocument are utf8 and String/Yson are binary
+ydb_status_t ydb_resultset_export_arrow(YdbResultSet *rs,
+                                        struct ArrowSchema *out_schema,
+                                        struct ArrowArray *out_array,
+                                        YdbResultDetails *rd);
+// one batch per stream chunk; the stream is owned by *out from here on and
+// freed by its release callback
+ydb_status_t ydb_result_stream_export_arrow(YdbResultStream *stream,
+                                            struct ArrowArrayStream *out,
+                                            YdbResultDetails *rd);
+
+/* ============================================================
+ * Client Metrics
+ * ============================================================ */
+typedef enum {
+  YDB_METRIC_GET_SESSION = 0, // wait for a pool session
+  YDB_METRIC_EXECUTE = 1,
+  YDB_METRIC_COMMIT = 2,
+  YDB_METRIC_ROLLBACK = 3,
+  YDB_METRIC_OP_COUNT
+} ydb_metric_op_t;
+
+typedef enum {
+  YDB_METRIC_RETRY_ATTEMPTS = 0,
+  YDB_METRIC_BYTES_RETURNED = 1,
+  YDB_METRIC_ROWS_RETURNED = 2,
+  YDB_METRIC_COUNTER_COUNT
+} ydb_metric_counter_t;
+
+typedef struct YdbLatencySummary {
+  uint64_t count;
+  uint64_t sum_us;
+  // upper bounds of the log-linear buckets, within 25% of the true value
+  uint64_t p50_us;
+  uint64_t p90_us;
+  uint64_t p99_us;
+  uint64_t max_us;
+} YdbLatencySummary;
+
+// recording is on by default and costs a few relaxed atomic adds per call
+void ydb_metrics_set_enabled(int enabled);
+// YDB_METRIC_BYTES_RETURNED stays 0 unless enabled: sizing a result set
+// walks its whole protobuf, which is O(result size) on every execute
+void ydb_metrics_set_count_bytes(int enabled);
+void ydb_metrics_reset(void);
+
+// a consistent-enough copy of all shards; concurrent updates may be split
+// between two snapshots but are never lost
+YdbMetricsSnapshot *ydb_metrics_snapshot(YdbResultDetails *rd);
+ydb_status_t ydb_metrics_snapshot_latency(const YdbMetricsSnapshot *s,
+                                          ydb_metric_op_t op,
+                                          YdbLatencySummary *out,
+                                          YdbResultDetails *rd);
+uint64_t ydb_metrics_snapshot_counter(const YdbMetricsSnapshot *s,
+                                      ydb_metric_counter_t counter);
+// how many SDK statuses mapped to `code`; YDB_OK counts successes
+uint64_t ydb_metrics_snapshot_status_count(const YdbMetricsSnapshot *s,
+                                           ydb_status_t code);
+// Prometheus text exposition format, owned by the snapshot
+const char *ydb_metrics_snapshot_prometheus(YdbMetricsSnapshot *s,
+                                            YdbResultDetails *rd);
+void ydb_metrics_snapshot_free(YdbMetricsSnapshot *s);
+
+/* ============================================================
+ * Tracing
+ * ============================================================ */
+typedef struct YdbSpanAttribute {
+  const char *key;
+  const char *value;
+} YdbSpanAttribute;
+
+// returns the caller's span handle; attrs are valid only during the call
+typedef void *(*ydb_span_start_callback_t)(const char *name,
+                                           const YdbSpanAttribute *attrs,
+                                           size_t n_attrs, void *user_data);
+typedef void (*ydb_span_end_callback_t)(void *span, ydb_status_t status,
+                                        uint64_t duration_us,
+                                        void *user_data);
+
+// spans run on the calling thread around GetSession, BeginTransaction,
+// ExecuteQuery, Commit, Rollback and result set iteration of every client
+// created from drv; NULL callbacks remove the tracer. The iteration span
+// covers rows read by next_row, fetch_columns or an Arrow export and ends
+// with the last row or when the result set is freed
+ydb_status_t ydb_driver_set_tracer(YdbDriver *drv,
+                                   ydb_span_start_callback_t start,
+                                   ydb_span_end_callback_t end,
+                                   void *user_data, YdbResultDetails *rd);
+// ExecuteQuery spans carry the first max_bytes of the YQL text, cut at a
+// UTF-8 boundary, as db.query.text. 0, the default, leaves it out: the text
+// may be large and may hold literals the trace backend should not see
+ydb_status_t ydb_driver_set_trace_query_text(YdbDriver *drv,
+                                            uint32_t max_bytes,
+                                            YdbResultDetails *rd);
+// W3C traceparent sent as request metadata with every call started on this
+// thread; NULL or "" clears it. Calling it from a start callback parents the
+// server side spans under that client span
+ydb_status_t ydb_trace_set_parent(const char *traceparent,
+                                  YdbResultDetails *rd);
+
 #ifdef __cplusplus
 }
 #endif
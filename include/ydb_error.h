@@ -14,10 +14,21 @@ typedef struct YdbResultDetails YdbResultDetails;
 
 void ydb_result_details_print(const char *message);
 
-int ydb_result_details_init(YdbResultDetails *rd);
+// codes_only: failures keep the code but no text, for callers that never
+// read get_message
+YdbResultDetails *ydb_result_details_create(int codes_only);
+int ydb_result_details_init(YdbResultDetails **out); /* 0 on success */
+// every call writes into the rd it is given, so an rd must not be shared
+// between threads. One object per thread, owned by the library; free is a
+// no-op on it
+YdbResultDetails *ydb_result_details_thread_local(void);
+// back to YDB_OK, so the object can be passed to the next call
 void ydb_result_details_reset(YdbResultDetails *rd);
 void ydb_result_details_free(YdbResultDetails *rd);
 
+ydb_status_t ydb_result_details_code(const YdbResultDetails *d);
+// formats the stored failure on first call; valid until the next failure
+// or reset on this object
 const char *get_message(const YdbResultDetails *d);
 
 ydb_status_t ydb_result_details_fail(YdbResultDetails *rd, ydb_status_t code,
@@ -0,0 +1,661 @@
+#include "include/ydb.h"
+#include "ydb_error.h"
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// log-linear latency histogram: 16 buckets per power of two, so an upper
+// bound is at most 1/16 above any sample it covers
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1u << HIST_SUB_BITS)
+#define HIST_BUCKETS (64 * HIST_SUB)
+
+#define MAX_STATUS 32
+#define PREFILL_BATCH 1000
+
+typedef enum {
+  WL_UPSERT,
+  WL_SELECT,
+  WL_SCAN,
+  WL_MIXED,
+  WL_OLTP,
+} workload_t;
+
+typedef struct {
+  const char *endpoint;
+  const char *database;
+  const char *table;
+  workload_t workload;
+  const char *workload_name;
+  int threads;
+  int seconds;
+  uint64_t keys;
+  int value_size;
+  int scan_limit;
+  int read_percent;
+  int per_thread_clients;
+  uint32_t max_sessions;
+  int init;
+  int json;
+} options_t;
+
+typedef struct {
+  uint64_t buckets[HIST_BUCKETS];
+  uint64_t max_us;
+} histogram_t;
+
+typedef struct {
+  pthread_t thread;
+  int id;
+  const options_t *opt;
+  YdbQueryClient *qc;
+  YdbResultDetails *rd;
+  YdbQueryParams *read_params;
+  YdbQueryParams *write_params;
+  YdbQueryParams *scan_params;
+  char *value;
+  uint64_t rng;
+  histogram_t hist;
+  uint64_t errors;
+  uint64_t rows;
+  uint64_t statuses[MAX_STATUS];
+  atomic_uint_fast64_t done;
+} worker_t;
+
+static atomic_int stop_flag;
+
+static char upsert_yql[512];
+static char select_yql[512];
+static char scan_yql[512];
+static char prefill_yql[512];
+
+static uint64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static int bit_width(uint64_t v) {
+  int n = 0;
+  while (v) {
+    ++n;
+    v >>= 1;
+  }
+  return n;
+}
+
+static size_t hist_bucket(uint64_t us) {
+  if (us < HIST_SUB) {
+    return (size_t)us;
+  }
+  const int shift = bit_width(us) - 1 - HIST_SUB_BITS;
+  const size_t sub = (size_t)(us >> shift) & (HIST_SUB - 1);
+  const size_t bucket = (size_t)(shift + 1) * HIST_SUB + sub;
+  return bucket < HIST_BUCKETS ? bucket : HIST_BUCKETS - 1;
+}
+
+static uint64_t hist_upper(size_t bucket) {
+  if (bucket < HIST_SUB) {
+    return bucket;
+  }
+  const int shift = (int)(bucket / HIST_SUB) - 1;
+  const uint64_t lower = (uint64_t)(HIST_SUB + bucket % HIST_SUB) << shift;
+  return lower + ((uint64_t)1 << shift) - 1;
+}
+
+static void hist_record(histogram_t *h, uint64_t us) {
+  ++h->buckets[hist_bucket(us)];
+  if (us > h->max_us) {
+    h->max_us = us;
+  }
+}
+
+// nearest rank, reported as the upper bound of its bucket
+static uint64_t hist_percentile(const histogram_t *h, uint64_t count,
+                                double q) {
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(q * (double)count);
+  if ((double)rank < q * (double)count || rank == 0) {
+    ++rank;
+  }
+  uint64_t seen = 0;
+  for (size_t i = 0; i < HIST_BUCKETS; ++i) {
+    seen += h->buckets[i];
+    if (seen >= rank) {
+      const uint64_t upper = hist_upper(i);
+      return upper < h->max_us ? upper : h->max_us;
+    }
+  }
+  return h->max_us;
+}
+
+static uint64_t next_rand(worker_t *w) {
+  // xorshift64*
+  w->rng ^= w->rng >> 12;
+  w->rng ^= w->rng << 25;
+  w->rng ^= w->rng >> 27;
+  return w->rng * 2685821657736338717ull;
+}
+
+static void count_status(worker_t *w, ydb_status_t st) {
+  int index = st > 0 ? 0 : -st;
+  if (index >= MAX_STATUS) {
+    index = MAX_STATUS - 1;
+  }
+  ++w->statuses[index];
+}
+
+static void count_rows(worker_t *w, YdbResultSets *out) {
+  YdbResultSet *set = out ? ydb_resultsets_release(out, 0, NULL) : NULL;
+  if (!set) {
+    return;
+  }
+  while (ydb_resultset_next_row(set, NULL)) {
+    ++w->rows;
+  }
+  ydb_resultset_free(set);
+}
+
+static ydb_status_t run_upsert(worker_t *w) {
+  const uint64_t key = next_rand(w) % w->opt->keys;
+  ydb_status_t st = ydb_params_set_uint64(w->write_params, "$key", key, w->rd);
+  if (st == YDB_OK) {
+    st = ydb_params_set_utf8(w->write_params, "$value", w->value, w->rd);
+  }
+  if (st == YDB_OK) {
+    st = ydb_query_execute_with_retry(w->qc, upsert_yql, w->write_params,
+                                      YDB_TX_SERIALIZABLE_RW, NULL, NULL,
+                                      w->rd);
+  }
+  return st;
+}
+
+static ydb_status_t run_select(worker_t *w) {
+  YdbResultSets *out = NULL;
+  const uint64_t key = next_rand(w) % w->opt->keys;
+  ydb_status_t st = ydb_params_set_uint64(w->read_params, "$key", key, w->rd);
+  if (st == YDB_OK) {
+    st = ydb_query_execute_with_retry(w->qc, select_yql, w->read_params,
+                                      YDB_TX_ONLINE_RO, NULL, &out, w->rd);
+  }
+  count_rows(w, out);
+  ydb_resultsets_free(out, NULL);
+  return st;
+}
+
+static ydb_status_t run_scan(worker_t *w) {
+  YdbResultSets *out = NULL;
+  const uint64_t from = next_rand(w) % w->opt->keys;
+  ydb_status_t st =
+      ydb_params_set_uint64(w->scan_params, "$from", from, w->rd);
+  if (st == YDB_OK) {
+    st = ydb_params_set_uint64(w->scan_params, "$limit",
+                               (uint64_t)w->opt->scan_limit, w->rd);
+  }
+  if (st == YDB_OK) {
+    st = ydb_query_execute_with_retry(w->qc, scan_yql, w->scan_params,
+                                      YDB_TX_SNAPSHOT_RO, NULL, &out, w->rd);
+  }
+  count_rows(w, out);
+  ydb_resultsets_free(out, NULL);
+  return st;
+}
+
+// read one key and write another in a single serializable transaction;
+// the lazy begin makes it two round trips in total
+static ydb_status_t run_oltp(worker_t *w) {
+  YdbQueryTransaction *tx = NULL;
+  YdbResultSets *out = NULL;
+  ydb_status_t st =
+      ydb_query_begin_tx_lazy(w->qc, YDB_TX_SERIALIZABLE_RW, &tx, w->rd);
+  if (st != YDB_OK) {
+    return st;
+  }
+  st = ydb_params_set_uint64(w->read_params, "$key",
+                             next_rand(w) % w->opt->keys, w->rd);
+  if (st == YDB_OK) {
+    st = ydb_query_tx_execute(tx, select_yql, w->read_params, &out, w->rd);
+  }
+  count_rows(w, out);
+  ydb_resultsets_free(out, NULL);
+  if (st == YDB_OK) {
+    st = ydb_params_set_uint64(w->write_params, "$key",
+                               next_rand(w) % w->opt->keys, w->rd);
+  }
+  if (st == YDB_OK) {
+    st = ydb_params_set_utf8(w->write_params, "$value", w->value, w->rd);
+  }
+  if (st == YDB_OK) {
+    st = ydb_query_tx_execute_commit(tx, upsert_yql, w->write_params, NULL,
+                                     w->rd);
+  }
+  if (st != YDB_OK) {
+    ydb_query_tx_rollback(tx, NULL);
+  }
+  ydb_query_tx_free(tx, NULL);
+  return st;
+}
+
+static ydb_status_t run_once(worker_t *w) {
+  switch (w->opt->workload) {
+  case WL_UPSERT:
+    return run_upsert(w);
+  case WL_SELECT:
+    return run_select(w);
+  case WL_SCAN:
+    return run_scan(w);
+  case WL_MIXED:
+    if ((int)(next_rand(w) % 100) < w->opt->read_percent) {
+      return run_select(w);
+    }
+    return run_upsert(w);
+  case WL_OLTP:
+    return run_oltp(w);
+  }
+  return YDB_ERR_BAD_REQUEST;
+}
+
+static void *worker_main(void *arg) {
+  worker_t *w = arg;
+  while (!atomic_load_explicit(&stop_flag, memory_order_relaxed)) {
+    ydb_result_details_reset(w->rd);
+    const uint64_t start = now_us();
+    const ydb_status_t st = run_once(w);
+    hist_record(&w->hist, now_us() - start);
+    count_status(w, st);
+    if (st != YDB_OK) {
+      ++w->errors;
+    }
+    atomic_fetch_add_explicit(&w->done, 1, memory_order_relaxed);
+  }
+  return NULL;
+}
+
+static int parse_workload(const char *name, workload_t *out) {
+  static const struct {
+    const char *name;
+    workload_t workload;
+  } names[] = {
+      {"upsert", WL_UPSERT}, {"select", WL_SELECT}, {"scan", WL_SCAN},
+      {"mixed", WL_MIXED},   {"oltp", WL_OLTP},
+  };
+  for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+    if (strcmp(name, names[i].name) == 0) {
+      *out = names[i].workload;
+      return 0;
+    }
+  }
+  return -1;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -e endpoint     YDB endpoint (localhost:2136)\n"
+          "  -d database     database path (/local)\n"
+          "  -T table        table name (loadgen_kv)\n"
+          "  -w workload     upsert|select|scan|mixed|oltp (mixed)\n"
+          "  -t threads      worker threads (8)\n"
+          "  -s seconds      run time (10)\n"
+          "  -k keys         key space (100000)\n"
+          "  -v bytes        value size (64)\n"
+          "  -l rows         scan limit (100)\n"
+          "  -r percent      reads in the mixed workload (90)\n"
+          "  -p sessions     session pool limit (threads)\n"
+          "  -c              one query client per thread\n"
+          "  -i              create and fill the table first\n"
+          "  -j              print the summary as JSON\n",
+          argv0);
+}
+
+static int parse_options(int argc, char **argv, options_t *opt) {
+  opt->endpoint = "localhost:2136";
+  opt->database = "/local";
+  opt->table = "loadgen_kv";
+  opt->workload = WL_MIXED;
+  opt->workload_name = "mixed";
+  opt->threads = 8;
+  opt->seconds = 10;
+  opt->keys = 100000;
+  opt->value_size = 64;
+  opt->scan_limit = 100;
+  opt->read_percent = 90;
+
+  int ch;
+  while ((ch = getopt(argc, argv, "e:d:T:w:t:s:k:v:l:r:p:cijh")) != -1) {
+    switch (ch) {
+    case 'e':
+      opt->endpoint = optarg;
+      break;
+    case 'd':
+      opt->database = optarg;
+      break;
+    case 'T':
+      opt->table = optarg;
+      break;
+    case 'w':
+      if (parse_workload(optarg, &opt->workload) != 0) {
+        fprintf(stderr, "unknown workload: %s\n", optarg);
+        return -1;
+      }
+      opt->workload_name = optarg;
+      break;
+    case 't':
+      opt->threads = atoi(optarg);
+      break;
+    case 's':
+      opt->seconds = atoi(optarg);
+      break;
+    case 'k':
+      opt->keys = strtoull(optarg, NULL, 10);
+      break;
+    case 'v':
+      opt->value_size = atoi(optarg);
+      break;
+    case 'l':
+      opt->scan_limit = atoi(optarg);
+      break;
+    case 'r':
+      opt->read_percent = atoi(optarg);
+      break;
+    case 'p':
+      opt->max_sessions = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'c':
+      opt->per_thread_clients = 1;
+      break;
+    case 'i':
+      opt->init = 1;
+      break;
+    case 'j':
+      opt->json = 1;
+      break;
+    default:
+      return -1;
+    }
+  }
+  if (opt->threads <= 0 || opt->seconds <= 0 || opt->keys == 0 ||
+      opt->value_size <= 0 || opt->scan_limit <= 0 ||
+      opt->read_percent < 0 || opt->read_percent > 100) {
+    fprintf(stderr, "invalid option value\n");
+    return -1;
+  }
+  if (opt->max_sessions == 0) {
+    opt->max_sessions = (uint32_t)opt->threads;
+  }
+  return 0;
+}
+
+static void format_queries(const options_t *opt) {
+  snprintf(upsert_yql, sizeof(upsert_yql),
+           "DECLARE $key AS Uint64;\n"
+           "DECLARE $value AS Utf8;\n"
+           "UPSERT INTO `%s` (key, value) VALUES ($key, $value);",
+           opt->table);
+  snprintf(select_yql, sizeof(select_yql),
+           "DECLARE $key AS Uint64;\n"
+           "SELECT value FROM `%s` WHERE key = $key;",
+           opt->table);
+  snprintf(scan_yql, sizeof(scan_yql),
+           "DECLARE $from AS Uint64;\n"
+           "DECLARE $limit AS Uint64;\n"
+           "SELECT key, value FROM `%s` WHERE key >= $from\n"
+           "ORDER BY key LIMIT $limit;",
+           opt->table);
+  snprintf(prefill_yql, sizeof(prefill_yql),
+           "DECLARE $rows AS List<Struct<key: Uint64, value: Utf8>>;\n"
+           "UPSERT INTO `%s` SELECT * FROM AS_TABLE($rows);",
+           opt->table);
+}
+
+// creates the table and upserts every key in batches of PREFILL_BATCH
+static ydb_status_t init_table(YdbQueryClient *qc, const options_t *opt,
+                               const char *value, YdbResultDetails *rd) {
+  char ddl[256];
+  snprintf(ddl, sizeof(ddl),
+           "CREATE TABLE IF NOT EXISTS `%s` ("
+           "  key   Uint64,"
+           "  value Utf8,"
+           "  PRIMARY KEY (key)"
+           ");",
+           opt->table);
+  ydb_status_t st = ydb_query_NOtx_execute(qc, ddl, NULL, NULL, rd);
+  if (st != YDB_OK) {
+    return st;
+  }
+
+  const size_t value_len = strlen(value);
+  uint64_t keys[PREFILL_BATCH];
+  uint32_t offsets[PREFILL_BATCH + 1];
+  char *values = malloc(value_len * PREFILL_BATCH);
+  YdbQueryParams *params = ydb_query_params_create(rd);
+  if (!values || !params) {
+    free(values);
+    ydb_query_params_free(params, NULL);
+    return values ? ydb_result_details_code(rd) : YDB_ERR_INTERNAL;
+  }
+  for (size_t i = 0; i < PREFILL_BATCH; ++i) {
+    memcpy(values + i * value_len, value, value_len);
+    offsets[i] = (uint32_t)(i * value_len);
+  }
+  offsets[PREFILL_BATCH] = (uint32_t)(PREFILL_BATCH * value_len);
+
+  for (uint64_t from = 0; from < opt->keys && st == YDB_OK;
+       from += PREFILL_BATCH) {
+    const size_t n = opt->keys - from < PREFILL_BATCH
+                         ? (size_t)(opt->keys - from)
+                         : PREFILL_BATCH;
+    for (size_t i = 0; i < n; ++i) {
+      keys[i] = from + i;
+    }
+    const YdbColumnBinding cols[] = {
+        {"key", YDB_TYPE_UINT64, keys, NULL, NULL},
+        {"value", YDB_TYPE_UTF8, values, offsets, NULL},
+    };
+    YdbParamBuilder *b = ydb_params_begin_param(params, "$rows", rd);
+    st = b ? ydb_params_bind_struct_list(b, n, 2, cols, rd)
+           : ydb_result_details_code(rd);
+    if (b && st == YDB_OK) {
+      st = ydb_params_end_param(b, rd);
+    }
+    if (st == YDB_OK) {
+      st = ydb_query_execute_with_retry(qc, prefill_yql, params,
+                                        YDB_TX_SERIALIZABLE_RW, NULL, NULL,
+                                        rd);
+    }
+  }
+  ydb_query_params_free(params, NULL);
+  free(values);
+  return st;
+}
+
+static void report(const options_t *opt, worker_t *workers, double elapsed) {
+  histogram_t total;
+  memset(&total, 0, sizeof(total));
+  uint64_t statuses[MAX_STATUS] = {0};
+  uint64_t ops = 0, errors = 0, rows = 0;
+  for (int i = 0; i < opt->threads; ++i) {
+    const worker_t *w = &workers[i];
+    for (size_t b = 0; b < HIST_BUCKETS; ++b) {
+      total.buckets[b] += w->hist.buckets[b];
+    }
+    if (w->hist.max_us > total.max_us) {
+      total.max_us = w->hist.max_us;
+    }
+    for (size_t s = 0; s < MAX_STATUS; ++s) {
+      statuses[s] += w->statuses[s];
+    }
+    ops += atomic_load(&w->done);
+    errors += w->errors;
+    rows += w->rows;
+  }
+  const double qps = elapsed > 0 ? (double)ops / elapsed : 0;
+  const uint64_t p50 = hist_percentile(&total, ops, 0.50);
+  const uint64_t p99 = hist_percentile(&total, ops, 0.99);
+  const uint64_t p999 = hist_percentile(&total, ops, 0.999);
+
+  if (opt->json) {
+    printf("{\"workload\":\"%s\",\"threads\":%d,\"clients\":%d,"
+           "\"sessions\":%" PRIu32 ",\"seconds\":%.3f,\"ops\":%" PRIu64
+           ",\"errors\":%" PRIu64 ",\"rows\":%" PRIu64 ",\"qps\":%.1f,"
+           "\"p50_us\":%" PRIu64 ",\"p99_us\":%" PRIu64
+           ",\"p999_us\":%" PRIu64 ",\"max_us\":%" PRIu64 ",\"statuses\":{",
+           opt->workload_name, opt->threads,
+           opt->per_thread_clients ? opt->threads : 1, opt->max_sessions,
+           elapsed, ops, errors, rows, qps, p50, p99, p999, total.max_us);
+    int first = 1;
+    for (size_t s = 0; s < MAX_STATUS; ++s) {
+      if (statuses[s]) {
+        printf("%s\"%d\":%" PRIu64, first ? "" : ",", -(int)s, statuses[s]);
+        first = 0;
+      }
+    }
+    printf("}}\n");
+    return;
+  }
+
+  printf("workload %s, %d threads, %s client(s), %" PRIu32 " sessions\n",
+         opt->workload_name, opt->threads,
+         opt->per_thread_clients ? "per-thread" : "shared",
+         opt->max_sessions);
+  printf("ops %" PRIu64 " in %.1fs: %.1f ops/s, %" PRIu64 " errors, %" PRIu64
+         " rows read\n",
+         ops, elapsed, qps, errors, rows);
+  printf("latency us: p50 %" PRIu64 "  p99 %" PRIu64 "  p999 %" PRIu64
+         "  max %" PRIu64 "\n",
+         p50, p99, p999, total.max_us);
+  for (size_t s = 1; s < MAX_STATUS; ++s) {
+    if (statuses[s]) {
+      printf("  status %d: %" PRIu64 "\n", -(int)s, statuses[s]);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  options_t opt;
+  memset(&opt, 0, sizeof(opt));
+  if (parse_options(argc, argv, &opt) != 0) {
+    usage(argv[0]);
+    return 2;
+  }
+  format_queries(&opt);
+
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  if (!rd) {
+    fprintf(stderr, "result details creation failed\n");
+    return 1;
+  }
+
+  YdbDriverConfig *cfg = ydb_driver_config_create(rd);
+  YdbDriver *drv = NULL;
+  if (cfg && ydb_driver_config_set_endpoint(cfg, opt.endpoint, rd) == YDB_OK &&
+      ydb_driver_config_set_database(cfg, opt.database, rd) == YDB_OK &&
+      ydb_driver_config_set_session_pool_size(cfg, 1, opt.max_sessions, rd) ==
+          YDB_OK) {
+    drv = ydb_driver_create(cfg, rd);
+  }
+  ydb_driver_config_free(cfg);
+  if (!drv) {
+    fprintf(stderr, "driver creation failed: %s\n", get_message(rd));
+    ydb_result_details_free(rd);
+    return 1;
+  }
+
+  worker_t *workers = calloc((size_t)opt.threads, sizeof(worker_t));
+  char *value = malloc((size_t)opt.value_size + 1);
+  YdbQueryClient *shared = ydb_query_client_create(drv, rd);
+  int rc = 1;
+  if (!workers || !value || !shared) {
+    fprintf(stderr, "setup failed: %s\n", get_message(rd));
+    goto cleanup;
+  }
+  memset(value, 'x', (size_t)opt.value_size);
+  value[opt.value_size] = '\0';
+
+  if (opt.init) {
+    if (init_table(shared, &opt, value, rd) != YDB_OK) {
+      fprintf(stderr, "table init failed: %s\n", get_message(rd));
+      goto cleanup;
+    }
+  }
+
+  for (int i = 0; i < opt.threads; ++i) {
+    worker_t *w = &workers[i];
+    w->id = i;
+    w->opt = &opt;
+    w->value = value;
+    w->rng = 0x9E3779B97F4A7C15ull * (uint64_t)(i + 1);
+    atomic_init(&w->done, 0);
+    w->qc = opt.per_thread_clients ? ydb_query_client_create(drv, rd) : shared;
+    w->rd = ydb_result_details_create(0);
+    w->read_params = ydb_query_params_create(rd);
+    w->write_params = ydb_query_params_create(rd);
+    w->scan_params = ydb_query_params_create(rd);
+    if (!w->qc || !w->rd || !w->read_params || !w->write_params ||
+        !w->scan_params) {
+      fprintf(stderr, "worker %d setup failed: %s\n", i, get_message(rd));
+      goto cleanup;
+    }
+  }
+
+  const uint64_t start = now_us();
+  int started = 0;
+  for (; started < opt.threads; ++started) {
+    if (pthread_create(&workers[started].thread, NULL, worker_main,
+                       &workers[started]) != 0) {
+      fprintf(stderr, "failed to start worker %d\n", started);
+      break;
+    }
+  }
+
+  // per-second throughput on stderr, to spot stalls and scaling cliffs
+  uint64_t last_ops = 0;
+  for (int sec = 1; sec <= opt.seconds && started == opt.threads; ++sec) {
+    sleep(1);
+    uint64_t ops = 0;
+    for (int i = 0; i < opt.threads; ++i) {
+      ops += atomic_load_explicit(&workers[i].done, memory_order_relaxed);
+    }
+    fprintf(stderr, "[%3ds] %" PRIu64 " ops/s\n", sec, ops - last_ops);
+    last_ops = ops;
+  }
+  atomic_store(&stop_flag, 1);
+  for (int i = 0; i < started; ++i) {
+    pthread_join(workers[i].thread, NULL);
+  }
+  const double elapsed = (double)(now_us() - start) / 1e6;
+
+  if (started == opt.threads) {
+    report(&opt, workers, elapsed);
+    rc = 0;
+  }
+
+cleanup:
+  if (workers) {
+    for (int i = 0; i < opt.threads; ++i) {
+      worker_t *w = &workers[i];
+      if (w->qc && w->qc != shared) {
+        ydb_query_client_free(w->qc);
+      }
+      ydb_query_params_free(w->read_params, NULL);
+      ydb_query_params_free(w->write_params, NULL);
+      ydb_query_params_free(w->scan_params, NULL);
+      ydb_result_details_free(w->rd);
+    }
+  }
+  free(workers);
+  free(value);
+  ydb_query_client_free(shared);
+  ydb_driver_free(drv);
+  ydb_result_details_free(rd);
+  return rc;
+}
@@ -32,7 +32,7 @@ int main(void) {
   YdbQueryTransaction *tx = NULL;
   YdbQueryParams *params = NULL;
 
-  if (ydb_result_details_init(rd) != 0) {
+  if (ydb_result_details_init(&rd) != 0) {
     fprintf(stderr, "result details creation failed\n");
     return 1;
   }
@@ -0,0 +1,89 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <cstddef>
+#include <new>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define YDB_C_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define YDB_C_ASAN 1
+#endif
+#endif
+
+#ifdef YDB_C_ASAN
+#include <sanitizer/asan_interface.h>
+#else
+#define ASAN_POISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#define ASAN_UNPOISON_MEMORY_REGION(addr, size) ((void)(addr), (void)(size))
+#endif
+
+namespace {
+
+constexpr size_t kDefaultArenaSize = 64 * 1024;
+
+thread_local YdbArena *current_arena = nullptr;
+
+} // namespace
+
+YdbArena *ydb_current_arena() { return current_arena; }
+
+extern "C" {
+
+YdbArena *ydb_arena_create(size_t initial_size, YdbResultDetails *rd) {
+  try {
+    auto *arena = new (std::nothrow)
+        YdbArena(initial_size ? initial_size : kDefaultArenaSize);
+    if (!arena) {
+      ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                              "failed to allocate arena");
+    }
+    return arena;
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+YdbArena *ydb_arena_bind(YdbArena *arena) {
+  YdbArena *previous = current_arena;
+  current_arena = arena;
+  return previous;
+}
+
+void ydb_arena_reset(YdbArena *arena) {
+  if (!arena) {
+    return;
+  }
+  try {
+    // oldest first: a YdbResultSets is created before the result sets it
+    // holds, so its deleters still find each child alive and arena-tagged.
+    // Destroyed objects are poisoned so ASAN catches any later touch
+    for (const auto &cleanup : arena->cleanups) {
+      cleanup.destroy(cleanup.object);
+      ASAN_POISON_MEMORY_REGION(cleanup.object, cleanup.size);
+    }
+    arena->cleanups.clear();
+    arena->resource.release();
+    ASAN_UNPOISON_MEMORY_REGION(arena->initial.get(), arena->initial_size);
+  } catch (...) {
+  }
+}
+
+void ydb_arena_free(YdbArena *arena) {
+  if (!arena) {
+    return;
+  }
+  ydb_arena_reset(arena);
+  if (current_arena == arena) {
+    current_arena = nullptr;
+  }
+  delete arena;
+}
+
+} // extern "C"
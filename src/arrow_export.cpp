@@ -0,0 +1,523 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <ydb-cpp-sdk/client/result/result.h>
+#include <ydb-cpp-sdk/client/value/value.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// stands in for empty buffers, which consumers may not accept as null
+const uint64_t kEmptyBuffer = 0;
+
+const char *arrow_format(NYdb::EPrimitiveType type) {
+  switch (type) {
+  case NYdb::EPrimitiveType::Bool:
+    return "b";
+  case NYdb::EPrimitiveType::Int8:
+    return "c";
+  case NYdb::EPrimitiveType::Uint8:
+    return "C";
+  case NYdb::EPrimitiveType::Int16:
+    return "s";
+  case NYdb::EPrimitiveType::Uint16:
+    return "S";
+  case NYdb::EPrimitiveType::Int32:
+    return "i";
+  case NYdb::EPrimitiveType::Uint32:
+    return "I";
+  case NYdb::EPrimitiveType::Int64:
+    return "l";
+  case NYdb::EPrimitiveType::Uint64:
+    return "L";
+  case NYdb::EPrimitiveType::Float:
+    return "f";
+  case NYdb::EPrimitiveType::Double:
+    return "g";
+  case NYdb::EPrimitiveType::Utf8:
+  case NYdb::EPrimitiveType::Json:
+  case NYdb::EPrimitiveType::JsonDocument:
+    return "u";
+  case NYdb::EPrimitiveType::String:
+  case NYdb::EPrimitiveType::Yson:
+    return "z";
+  case NYdb::EPrimitiveType::Date:
+    return "tdD";
+  case NYdb::EPrimitiveType::Datetime:
+    return "tss:";
+  case NYdb::EPrimitiveType::Timestamp:
+    return "tsu:";
+  case NYdb::EPrimitiveType::Interval:
+    return "tDu";
+  default:
+    return nullptr;
+  }
+}
+
+void set_bit(std::vector<uint8_t> &bits, int64_t index, bool value) {
+  const size_t byte = static_cast<size_t>(index / 8);
+  if (bits.size() <= byte) {
+    bits.resize(byte + 1, 0);
+  }
+  if (value) {
+    bits[byte] |= static_cast<uint8_t>(1u << (index % 8));
+  }
+}
+
+template <typename T> void append_fixed(std::vector<uint8_t> &values, T v) {
+  const size_t at = values.size();
+  values.resize(at + sizeof(T));
+  std::memcpy(values.data() + at, &v, sizeof(T));
+}
+
+/* ── Column builders ─────────────────────────────────────────────── */
+
+// one per column; owned by the child ArrowArray once exported
+struct ArrowColumnData {
+  NYdb::EPrimitiveType type;
+  bool nullable;
+  std::vector<uint8_t> validity;
+  std::vector<uint8_t> values;
+  std::vector<int32_t> offsets{0};
+  std::vector<char> data;
+  int64_t length = 0;
+  int64_t null_count = 0;
+  const void *buffers[3] = {nullptr, nullptr, nullptr};
+
+  bool is_string() const {
+    return type == NYdb::EPrimitiveType::Utf8 ||
+           type == NYdb::EPrimitiveType::String ||
+           type == NYdb::EPrimitiveType::Json ||
+           type == NYdb::EPrimitiveType::JsonDocument ||
+           type == NYdb::EPrimitiveType::Yson;
+  }
+
+  void append_string(const std::string &v) {
+    if (v.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max() -
+                                       offsets.back())) {
+      throw std::length_error("string column exceeds 2 GiB in one batch");
+    }
+    data.insert(data.end(), v.begin(), v.end());
+    offsets.push_back(offsets.back() + static_cast<int32_t>(v.size()));
+  }
+
+  void append(NYdb::TValueParser &p) {
+    bool valid = true;
+    if (nullable) {
+      p.OpenOptional();
+      valid = !p.IsNull();
+      set_bit(validity, length, valid);
+      if (!valid) {
+        ++null_count;
+      }
+    }
+    if (!valid) {
+      append_null();
+    } else {
+      append_value(p);
+    }
+    if (nullable) {
+      p.CloseOptional();
+    }
+    ++length;
+  }
+
+  void append_null() {
+    if (is_string()) {
+      offsets.push_back(offsets.back());
+    } else if (type == NYdb::EPrimitiveType::Bool) {
+      set_bit(values, length, false);
+    } else {
+      values.resize(values.size() + fixed_width(), 0);
+    }
+  }
+
+  size_t fixed_width() const {
+    switch (type) {
+    case NYdb::EPrimitiveType::Int8:
+    case NYdb::EPrimitiveType::Uint8:
+      return 1;
+    case NYdb::EPrimitiveType::Int16:
+    case NYdb::EPrimitiveType::Uint16:
+      return 2;
+    case NYdb::EPrimitiveType::Int32:
+    case NYdb::EPrimitiveType::Uint32:
+    case NYdb::EPrimitiveType::Float:
+    case NYdb::EPrimitiveType::Date: // exported as date32
+      return 4;
+    default:
+      return 8;
+    }
+  }
+
+  void append_value(NYdb::TValueParser &p) {
+    switch (type) {
+    case NYdb::EPrimitiveType::Bool:
+      return set_bit(values, length, p.GetBool());
+    case NYdb::EPrimitiveType::Int8:
+      return append_fixed(values, p.GetInt8());
+    case NYdb::EPrimitiveType::Uint8:
+      return append_fixed(values, p.GetUint8());
+    case NYdb::EPrimitiveType::Int16:
+      return append_fixed(values, p.GetInt16());
+    case NYdb::EPrimitiveType::Uint16:
+      return append_fixed(values, p.GetUint16());
+    case NYdb::EPrimitiveType::Int32:
+      return append_fixed(values, p.GetInt32());
+    case NYdb::EPrimitiveType::Uint32:
+      return append_fixed(values, p.GetUint32());
+    case NYdb::EPrimitiveType::Int64:
+      return append_fixed(values, p.GetInt64());
+    case NYdb::EPrimitiveType::Uint64:
+      return append_fixed(values, p.GetUint64());
+    case NYdb::EPrimitiveType::Float:
+      return append_fixed(values, p.GetFloat());
+    case NYdb::EPrimitiveType::Double:
+      return append_fixed(values, p.GetDouble());
+    case NYdb::EPrimitiveType::Date:
+      return append_fixed<int32_t>(values, p.GetDate().Days());
+    case NYdb::EPrimitiveType::Datetime:
+      return append_fixed<int64_t>(values, p.GetDatetime().Seconds());
+    case NYdb::EPrimitiveType::Timestamp:
+      return append_fixed<int64_t>(values, p.GetTimestamp().MicroSeconds());
+    case NYdb::EPrimitiveType::Interval:
+      return append_fixed<int64_t>(values, p.GetInterval());
+    case NYdb::EPrimitiveType::Utf8:
+      return append_string(p.GetUtf8());
+    case NYdb::EPrimitiveType::Json:
+      return append_string(p.GetJson());
+    case NYdb::EPrimitiveType::JsonDocument:
+      return append_string(p.GetJsonDocument());
+    case NYdb::EPrimitiveType::Yson:
+      return append_string(p.GetYson());
+    default:
+      return append_string(p.GetString());
+    }
+  }
+};
+
+/* ── Release callbacks ───────────────────────────────────────────── */
+
+struct ArrowSchemaData {
+  std::string format;
+  std::string name;
+  std::vector<ArrowSchema> children;
+  std::vector<ArrowSchema *> child_ptrs;
+};
+
+void release_schema(ArrowSchema *schema) {
+  auto *data = static_cast<ArrowSchemaData *>(schema->private_data);
+  for (auto &child : data->children) {
+    if (child.release) {
+      child.release(&child);
+    }
+  }
+  delete data;
+  schema->release = nullptr;
+}
+
+void release_column(ArrowArray *array) {
+  delete static_cast<ArrowColumnData *>(array->private_data);
+  array->release = nullptr;
+}
+
+struct ArrowBatchData {
+  std::vector<ArrowArray> children;
+  std::vector<ArrowArray *> child_ptrs;
+  const void *buffers[1] = {nullptr};
+};
+
+void release_batch(ArrowArray *array) {
+  auto *data = static_cast<ArrowBatchData *>(array->private_data);
+  for (auto &child : data->children) {
+    if (child.release) {
+      child.release(&child);
+    }
+  }
+  delete data;
+  array->release = nullptr;
+}
+
+/* ── Export ──────────────────────────────────────────────────────── */
+
+struct ArrowField {
+  std::string name;
+  NYdb::EPrimitiveType type;
+  bool nullable;
+};
+
+std::vector<ArrowField> arrow_fields(const YdbResultSet &rs) {
+  std::vector<ArrowField> fields;
+  for (const auto &info : rs.schema) {
+    const auto type = static_cast<NYdb::EPrimitiveType>(info.type);
+    if (info.type == YDB_TYPE_UNKNOWN || info.type == YDB_TYPE_DECIMAL ||
+        !arrow_format(type)) {
+      throw std::invalid_argument(std::string("column ") + info.name +
+                                  " has no Arrow mapping");
+    }
+    fields.push_back({info.name, type, info.nullable != 0});
+  }
+  return fields;
+}
+
+void export_schema(const std::vector<ArrowField> &fields, ArrowSchema *out) {
+  auto data = std::make_unique<ArrowSchemaData>();
+  data->format = "+s";
+  data->children.resize(fields.size());
+  for (size_t i = 0; i < fields.size(); ++i) {
+    auto child = std::make_unique<ArrowSchemaData>();
+    child->format = arrow_format(fields[i].type);
+    child->name = fields[i].name;
+
+    ArrowSchema &c = data->children[i];
+    c = ArrowSchema{};
+    c.format = child->format.c_str();
+    c.name = child->name.c_str();
+    c.flags = fields[i].nullable ? ARROW_FLAG_NULLABLE : 0;
+    c.release = release_schema;
+    c.private_data = child.release();
+  }
+  for (auto &child : data->children) {
+    data->child_ptrs.push_back(&child);
+  }
+
+  *out = ArrowSchema{};
+  out->format = data->format.c_str();
+  out->name = "";
+  out->n_children = static_cast<int64_t>(fields.size());
+  out->children = data->child_ptrs.empty() ? nullptr : data->child_ptrs.data();
+  out->release = release_schema;
+  out->private_data = data.release();
+}
+
+// consumes the rows left in rs
+void export_batch(YdbResultSet *rs, const std::vector<ArrowField> &fields,
+                  ArrowArray *out) {
+  std::vector<std::unique_ptr<ArrowColumnData>> columns;
+  columns.reserve(fields.size());
+  const size_t rows = rs->resultSet.RowsCount();
+  for (const auto &field : fields) {
+    auto column = std::make_unique<ArrowColumnData>();
+    column->type = field.type;
+    column->nullable = field.nullable;
+    if (column->is_string()) {
+      column->offsets.reserve(rows + 1);
+    }
+    columns.push_back(std::move(column));
+  }
+
+  int64_t length = 0;
+  while (rs->advance()) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      columns[i]->append(rs->parser.ColumnParser(i));
+    }
+    ++length;
+  }
+
+  auto batch = std::make_unique<ArrowBatchData>();
+  batch->children.resize(columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    auto &col = *columns[i];
+    col.buffers[0] = col.null_count > 0 ? col.validity.data() : nullptr;
+    if (col.is_string()) {
+      col.buffers[1] = col.offsets.data();
+      col.buffers[2] = col.data.empty() ? &kEmptyBuffer : col.data.data();
+    } else {
+      col.buffers[1] = col.values.empty() ? &kEmptyBuffer : col.values.data();
+    }
+
+    ArrowArray &c = batch->children[i];
+    c = ArrowArray{};
+    c.length = col.length;
+    c.null_count = col.null_count;
+    c.n_buffers = col.is_string() ? 3 : 2;
+    c.buffers = col.buffers;
+    c.release = release_column;
+    c.private_data = columns[i].release();
+  }
+  for (auto &child : batch->children) {
+    batch->child_ptrs.push_back(&child);
+  }
+
+  *out = ArrowArray{};
+  out->length = length;
+  out->n_buffers = 1;
+  out->buffers = batch->buffers;
+  out->n_children = static_cast<int64_t>(columns.size());
+  out->children =
+      batch->child_ptrs.empty() ? nullptr : batch->child_ptrs.data();
+  out->release = release_batch;
+  out->private_data = batch.release();
+}
+
+/* ── Stream ──────────────────────────────────────────────────────── */
+
+struct ArrowStreamData {
+  YdbResultStream *stream;
+  YdbArenaPtr<YdbResultSet> pending; // first chunk, read for the schema
+  std::optional<std::vector<ArrowField>> fields;
+  int64_t index = 0;
+  std::string last_error;
+};
+
+// reads the next chunk; nullptr at the end of the stream
+YdbArenaPtr<YdbResultSet> stream_next(ArrowStreamData *data) {
+  if (data->pending) {
+    return std::move(data->pending);
+  }
+  YdbResultSet *set = nullptr;
+  int64_t index = 0;
+  YdbResultDetails details;
+  const ydb_status_t code =
+      ydb_result_stream_next_part(data->stream, &set, &index, &details);
+  if (code == YDB_ERR_NO_MORE_RESULTS) {
+    return nullptr;
+  }
+  if (code != YDB_OK) {
+    throw std::runtime_error(get_message(&details));
+  }
+  YdbArenaPtr<YdbResultSet> chunk(set);
+  if (data->fields.has_value() && index != data->index) {
+    throw std::invalid_argument("stream carries more than one result set");
+  }
+  data->index = index;
+  return chunk;
+}
+
+int stream_ensure_fields(ArrowStreamData *data) {
+  if (data->fields.has_value()) {
+    return 0;
+  }
+  data->pending = stream_next(data);
+  if (!data->pending) {
+    data->last_error = "stream returned no result sets";
+    return ENODATA;
+  }
+  data->fields = arrow_fields(*data->pending);
+  return 0;
+}
+
+int stream_get_schema(ArrowArrayStream *stream, ArrowSchema *out) {
+  auto *data = static_cast<ArrowStreamData *>(stream->private_data);
+  try {
+    if (const int err = stream_ensure_fields(data)) {
+      return err;
+    }
+    export_schema(*data->fields, out);
+    return 0;
+  } catch (const std::exception &e) {
+    data->last_error = e.what();
+    return EIO;
+  }
+}
+
+int stream_get_next(ArrowArrayStream *stream, ArrowArray *out) {
+  auto *data = static_cast<ArrowStreamData *>(stream->private_data);
+  try {
+    if (const int err = stream_ensure_fields(data)) {
+      if (err == ENODATA) {
+        out->release = nullptr;
+        return 0;
+      }
+      return err;
+    }
+    auto chunk = stream_next(data);
+    if (!chunk) {
+      out->release = nullptr;
+      return 0;
+    }
+    export_batch(chunk.get(), *data->fields, out);
+    return 0;
+  } catch (const std::exception &e) {
+    data->last_error = e.what();
+    return EIO;
+  }
+}
+
+const char *stream_get_last_error(ArrowArrayStream *stream) {
+  auto *data = static_cast<ArrowStreamData *>(stream->private_data);
+  return data->last_error.empty() ? nullptr : data->last_error.c_str();
+}
+
+void stream_release(ArrowArrayStream *stream) {
+  auto *data = static_cast<ArrowStreamData *>(stream->private_data);
+  ydb_result_stream_free(data->stream);
+  delete data;
+  stream->release = nullptr;
+}
+
+} // namespace
+
+extern "C" {
+
+ydb_status_t ydb_resultset_export_arrow(YdbResultSet *rs,
+                                        struct ArrowSchema *out_schema,
+                                        struct ArrowArray *out_array,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!rs || !out_schema || !out_array) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid arrow export arguments");
+    }
+    const auto fields = arrow_fields(*rs);
+    ArrowSchema schema{};
+    export_schema(fields, &schema);
+    try {
+      export_batch(rs, fields, out_array);
+    } catch (...) {
+      schema.release(&schema);
+      throw;
+    }
+    *out_schema = schema;
+    return YDB_OK;
+  } catch (const std::invalid_argument &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, e.what());
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_result_stream_export_arrow(YdbResultStream *stream,
+                                            struct ArrowArrayStream *out,
+                                            YdbResultDetails *rd) {
+  try {
+    if (!stream || !out) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid arrow stream arguments");
+    }
+    auto *data = new (std::nothrow) ArrowStreamData();
+    if (!data) {
+      return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                     "failed to allocate arrow stream");
+    }
+    data->stream = stream;
+
+    *out = ArrowArrayStream{};
+    out->get_schema = stream_get_schema;
+    out->get_next = stream_get_next;
+    out->get_last_error = stream_get_last_error;
+    out->release = stream_release;
+    out->private_data = data;
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+} // extern "C"
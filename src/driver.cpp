@@ -3,16 +3,25 @@
 #include "ydb_error.h"
 
 #include <cstdint>
+#include <ydb-cpp-sdk/client/discovery/discovery.h>
 #include <ydb-cpp-sdk/client/driver/driver.h>
 #include <ydb-cpp-sdk/client/params/params.h>
+#include <ydb-cpp-sdk/client/proto/accessor.h>
 #include <ydb-cpp-sdk/client/query/client.h>
 #include <ydb-cpp-sdk/client/table/table.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 #include <ydb-cpp-sdk/client/value/value.h>
 
 // i think macros are viable here bc they are now being injected into code
@@ -88,7 +97,11 @@ ydb_status_t status_to_ydb_code(NYdb::EStatus s) {
   case NYdb::EStatus::INTERNAL_ERROR:
     return YDB_ERR_INTERNAL;
   case NYdb::EStatus::TIMEOUT:
+  case NYdb::EStatus::CLIENT_DEADLINE_EXCEEDED:
     return YDB_ERR_TIMEOUT;
+  case NYdb::EStatus::CANCELLED:
+  case NYdb::EStatus::CLIENT_CANCELLED:
+    return YDB_ERR_CANCELLED;
   case NYdb::EStatus::ABORTED:
   case NYdb::EStatus::UNAVAILABLE:
   case NYdb::EStatus::OVERLOADED:
@@ -97,13 +110,511 @@ ydb_status_t status_to_ydb_code(NYdb::EStatus s) {
   case NYdb::EStatus::SESSION_BUSY:
   case NYdb::EStatus::SESSION_EXPIRED:
   case NYdb::EStatus::TRANSPORT_UNAVAILABLE:
-  case NYdb::EStatus::CLIENT_UNAUTHENTICATED:
     return YDB_ERR_CONNECTION;
+  case NYdb::EStatus::UNAUTHORIZED:
+  case NYdb::EStatus::CLIENT_UNAUTHENTICATED:
+    return YDB_ERR_UNAUTHORIZED;
   default:
     return YDB_ERR_GENERIC;
   }
 }
 
+namespace {
+
+bool binding_row_valid(const YdbColumnBinding &c, size_t row) {
+  return !c.validity || ((c.validity[row / 8] >> (row % 8)) & 1) != 0;
+}
+
+std::optional<NYdb::EPrimitiveType> binding_primitive(ydb_type_t type) {
+  switch (type) {
+  case YDB_TYPE_BOOL:
+  case YDB_TYPE_INT32:
+  case YDB_TYPE_UINT32:
+  case YDB_TYPE_INT64:
+  case YDB_TYPE_UINT64:
+  case YDB_TYPE_FLOAT:
+  case YDB_TYPE_DOUBLE:
+  case YDB_TYPE_UTF8:
+  case YDB_TYPE_BYTES:
+    return static_cast<NYdb::EPrimitiveType>(type);
+  default:
+    return std::nullopt;
+  }
+}
+
+template <typename T>
+T binding_value(const YdbColumnBinding &c, size_t row) {
+  return static_cast<const T *>(c.values)[row];
+}
+
+// offsets are only read for non-NULL rows, so only those have to be ordered
+bool binding_offsets_valid(const YdbColumnBinding &c, size_t n_rows) {
+  for (size_t row = 0; row < n_rows; ++row) {
+    if (binding_row_valid(c, row) && c.offsets[row + 1] < c.offsets[row]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string binding_string(const YdbColumnBinding &c, size_t row) {
+  const uint32_t begin = c.offsets[row];
+  const uint32_t end = c.offsets[row + 1];
+  return std::string(static_cast<const char *>(c.values) + begin, end - begin);
+}
+
+template <typename T>
+std::optional<T> binding_optional(T value, bool valid) {
+  return valid ? std::optional<T>(std::move(value)) : std::nullopt;
+}
+
+void bind_member(NYdb::TValueBuilder &v, const std::string &name,
+                 const YdbColumnBinding &c, size_t row) {
+  auto &m = v.AddMember(name);
+  const bool nullable = c.validity != nullptr;
+  const bool valid = binding_row_valid(c, row);
+  switch (c.type) {
+  case YDB_TYPE_BOOL: {
+    const bool x = binding_value<uint8_t>(c, row) != 0;
+    nullable ? m.OptionalBool(binding_optional(x, valid)) : m.Bool(x);
+    break;
+  }
+  case YDB_TYPE_INT32: {
+    const auto x = binding_value<int32_t>(c, row);
+    nullable ? m.OptionalInt32(binding_optional(x, valid)) : m.Int32(x);
+    break;
+  }
+  case YDB_TYPE_UINT32: {
+    const auto x = binding_value<uint32_t>(c, row);
+    nullable ? m.OptionalUint32(binding_optional(x, valid)) : m.Uint32(x);
+    break;
+  }
+  case YDB_TYPE_INT64: {
+    const auto x = binding_value<int64_t>(c, row);
+    nullable ? m.OptionalInt64(binding_optional(x, valid)) : m.Int64(x);
+    break;
+  }
+  case YDB_TYPE_UINT64: {
+    const auto x = binding_value<uint64_t>(c, row);
+    nullable ? m.OptionalUint64(binding_optional(x, valid)) : m.Uint64(x);
+    break;
+  }
+  case YDB_TYPE_FLOAT: {
+    const auto x = binding_value<float>(c, row);
+    nullable ? m.OptionalFloat(binding_optional(x, valid)) : m.Float(x);
+    break;
+  }
+  case YDB_TYPE_DOUBLE: {
+    const auto x = binding_value<double>(c, row);
+    nullable ? m.OptionalDouble(binding_optional(x, valid)) : m.Double(x);
+    break;
+  }
+  case YDB_TYPE_UTF8:
+    if (!nullable) {
+      m.Utf8(binding_string(c, row));
+    } else {
+      m.OptionalUtf8(valid ? std::optional<std::string>(binding_string(c, row))
+                           : std::nullopt);
+    }
+    break;
+  case YDB_TYPE_BYTES:
+    if (!nullable) {
+      m.String(binding_string(c, row));
+    } else {
+      m.OptionalString(valid
+                           ? std::optional<std::string>(binding_string(c, row))
+                           : std::nullopt);
+    }
+    break;
+  default:
+    throw std::invalid_argument("unsupported column type");
+  }
+}
+
+void set_view(YdbValue *out, const std::string &value) {
+  out->value.str.data = value.data();
+  out->value.str.len = value.size();
+}
+
+// the current row's cell as sent by the server; the value parser only
+// hands out UUID and Decimal as SDK structs without a public 128-bit view
+const Ydb::Value &raw_cell(const YdbResultSet &rs, size_t col) {
+  const auto &rows = NYdb::TProtoAccessor::GetProto(rs.resultSet).rows();
+  if (rs.rows_read == 0 || rs.rows_read > static_cast<size_t>(rows.size())) {
+    throw std::out_of_range("result set has no current row");
+  }
+  return rows[static_cast<int>(rs.rows_read - 1)].items(static_cast<int>(col));
+}
+
+// decodes one cell by the column type cached in the schema, so the parser
+// is only asked for the type it holds and the hot path does not throw.
+// String views point into the result set's protobuf and live as long as
+// the YdbResultSet. false for types YdbValue cannot hold
+bool read_cell(NYdb::TValueParser &p, const YdbResultSet &rs, size_t col,
+               YdbValue *out) {
+  const YdbColumnInfo &info = rs.schema[col];
+  out->type = info.type;
+  out->is_null = 0;
+  std::memset(&out->value, 0, sizeof(out->value));
+  if (info.nullable) {
+    p.OpenOptional();
+    if (p.IsNull()) {
+      p.CloseOptional();
+      out->is_null = 1;
+      return info.type != YDB_TYPE_UNKNOWN;
+    }
+  }
+  auto &v = out->value;
+  bool known = true;
+  switch (info.type) {
+  case YDB_TYPE_BOOL:
+    v.boolean = p.GetBool() ? 1 : 0;
+    break;
+  case YDB_TYPE_INT8:
+    v.i64 = p.GetInt8();
+    break;
+  case YDB_TYPE_INT16:
+    v.i64 = p.GetInt16();
+    break;
+  case YDB_TYPE_INT32:
+    v.i64 = p.GetInt32();
+    break;
+  case YDB_TYPE_INT64:
+    v.i64 = p.GetInt64();
+    break;
+  case YDB_TYPE_UINT8:
+    v.u64 = p.GetUint8();
+    break;
+  case YDB_TYPE_UINT16:
+    v.u64 = p.GetUint16();
+    break;
+  case YDB_TYPE_UINT32:
+    v.u64 = p.GetUint32();
+    break;
+  case YDB_TYPE_UINT64:
+    v.u64 = p.GetUint64();
+    break;
+  case YDB_TYPE_FLOAT:
+    v.f32 = p.GetFloat();
+    break;
+  case YDB_TYPE_DOUBLE:
+    v.f64 = p.GetDouble();
+    break;
+  case YDB_TYPE_DATE:
+    v.u64 = p.GetDate().Days();
+    break;
+  case YDB_TYPE_DATETIME:
+    v.u64 = p.GetDatetime().Seconds();
+    break;
+  case YDB_TYPE_TIMESTAMP:
+    v.u64 = p.GetTimestamp().MicroSeconds();
+    break;
+  case YDB_TYPE_INTERVAL:
+    v.i64 = p.GetInterval();
+    break;
+  case YDB_TYPE_UTF8:
+    set_view(out, p.GetUtf8());
+    break;
+  case YDB_TYPE_BYTES:
+    set_view(out, p.GetString());
+    break;
+  case YDB_TYPE_JSON:
+    set_view(out, p.GetJson());
+    break;
+  case YDB_TYPE_JSON_DOC:
+    set_view(out, p.GetJsonDocument());
+    break;
+  case YDB_TYPE_UUID: {
+    // little-endian halves, the byte order YDB stores a UUID in
+    const Ydb::Value &cell = raw_cell(rs, col);
+    for (size_t i = 0; i < 8; ++i) {
+      v.uuid[i] = static_cast<uint8_t>(cell.low_128() >> (8 * i));
+      v.uuid[i + 8] = static_cast<uint8_t>(cell.high_128() >> (8 * i));
+    }
+    break;
+  }
+  case YDB_TYPE_DECIMAL: {
+    const Ydb::Value &cell = raw_cell(rs, col);
+    v.decimal.low = cell.low_128();
+    v.decimal.high = static_cast<int64_t>(cell.high_128());
+    v.decimal.precision = info.decimal_precision;
+    v.decimal.scale = info.decimal_scale;
+    break;
+  }
+  default:
+    known = false;
+    break;
+  }
+  if (info.nullable) {
+    p.CloseOptional();
+  }
+  return known;
+}
+
+ydb_status_t read_value(YdbResultSet *rs, int col, YdbValue *out,
+                        YdbResultDetails *rd) {
+  if (!rs || col < 0 || static_cast<size_t>(col) >= rs->schema.size()) {
+    return RD(YDB_ERR_BAD_REQUEST, "invalid column index");
+  }
+  try {
+    const auto index = static_cast<size_t>(col);
+    if (!read_cell(rs->parser.ColumnParser(index), *rs, index, out)) {
+      return RD(YDB_ERR_BAD_REQUEST, "column type has no scalar value");
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return RD(YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+// convert returns false when the column's type does not fit T losslessly;
+// *out is left alone on every failure
+template <typename T, typename Convert>
+ydb_status_t get_scalar(YdbResultSet *rs, int col, T *out,
+                        const char *mismatch, Convert convert,
+                        YdbResultDetails *rd) {
+  if (!out) {
+    return RD(YDB_ERR_BAD_REQUEST, "output pointer is null");
+  }
+  YdbValue v;
+  if (const ydb_status_t st = read_value(rs, col, &v, rd); st != YDB_OK) {
+    return st;
+  }
+  T value{};
+  if (!convert(v, &value)) {
+    return RD(YDB_ERR_BAD_REQUEST, mismatch);
+  }
+  if (v.is_null) {
+    return RD(YDB_ERR_NOT_FOUND, "column value is null");
+  }
+  *out = value;
+  return YDB_OK;
+}
+
+bool is_signed_int(ydb_type_t type) {
+  return type == YDB_TYPE_INT8 || type == YDB_TYPE_INT16 ||
+         type == YDB_TYPE_INT32 || type == YDB_TYPE_INT64;
+}
+
+bool is_unsigned_int(ydb_type_t type) {
+  return type == YDB_TYPE_UINT8 || type == YDB_TYPE_UINT16 ||
+         type == YDB_TYPE_UINT32 || type == YDB_TYPE_UINT64;
+}
+
+bool is_string(ydb_type_t type) {
+  return type == YDB_TYPE_UTF8 || type == YDB_TYPE_BYTES ||
+         type == YDB_TYPE_JSON || type == YDB_TYPE_JSON_DOC;
+}
+
+ydb_status_t get_view(YdbResultSet *rs, int col, bool text, const char **out,
+                      size_t *out_len, YdbResultDetails *rd) {
+  if (!out || !out_len) {
+    return RD(YDB_ERR_BAD_REQUEST, "output pointer is null");
+  }
+  YdbValue v;
+  if (const ydb_status_t st = read_value(rs, col, &v, rd); st != YDB_OK) {
+    return st;
+  }
+  // BYTES is the only string type that is not text
+  if (!is_string(v.type) || (text && v.type == YDB_TYPE_BYTES)) {
+    return RD(YDB_ERR_BAD_REQUEST,
+              text ? "column is not text" : "column is not a string");
+  }
+  if (v.is_null) {
+    return RD(YDB_ERR_NOT_FOUND, "column value is null");
+  }
+  *out = v.value.str.data;
+  *out_len = v.value.str.len;
+  return YDB_OK;
+}
+
+// 0 for variable-width types, which go through offsets + data
+size_t fetch_width(NYdb::EPrimitiveType type) {
+  switch (type) {
+  case NYdb::EPrimitiveType::Bool:
+  case NYdb::EPrimitiveType::Int8:
+  case NYdb::EPrimitiveType::Uint8:
+    return 1;
+  case NYdb::EPrimitiveType::Int16:
+  case NYdb::EPrimitiveType::Uint16:
+  case NYdb::EPrimitiveType::Date:
+    return 2;
+  case NYdb::EPrimitiveType::Int32:
+  case NYdb::EPrimitiveType::Uint32:
+  case NYdb::EPrimitiveType::Float:
+  case NYdb::EPrimitiveType::Datetime:
+    return 4;
+  case NYdb::EPrimitiveType::Int64:
+  case NYdb::EPrimitiveType::Uint64:
+  case NYdb::EPrimitiveType::Double:
+  case NYdb::EPrimitiveType::Timestamp:
+  case NYdb::EPrimitiveType::Interval:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+bool fetch_is_string(NYdb::EPrimitiveType type) {
+  return type == NYdb::EPrimitiveType::Utf8 ||
+         type == NYdb::EPrimitiveType::String ||
+         type == NYdb::EPrimitiveType::Json ||
+         type == NYdb::EPrimitiveType::JsonDocument;
+}
+
+template <typename T> void fetch_store(void *values, size_t row, T value) {
+  static_cast<T *>(values)[row] = value;
+}
+
+void fetch_store_fixed(NYdb::TValueParser &p, NYdb::EPrimitiveType type,
+                       void *values, size_t row) {
+  switch (type) {
+  case NYdb::EPrimitiveType::Bool:
+    return fetch_store<uint8_t>(values, row, p.GetBool() ? 1 : 0);
+  case NYdb::EPrimitiveType::Int8:
+    return fetch_store(values, row, p.GetInt8());
+  case NYdb::EPrimitiveType::Uint8:
+    return fetch_store(values, row, p.GetUint8());
+  case NYdb::EPrimitiveType::Int16:
+    return fetch_store(values, row, p.GetInt16());
+  case NYdb::EPrimitiveType::Uint16:
+    return fetch_store(values, row, p.GetUint16());
+  case NYdb::EPrimitiveType::Int32:
+    return fetch_store(values, row, p.GetInt32());
+  case NYdb::EPrimitiveType::Uint32:
+    return fetch_store(values, row, p.GetUint32());
+  case NYdb::EPrimitiveType::Int64:
+    return fetch_store(values, row, p.GetInt64());
+  case NYdb::EPrimitiveType::Uint64:
+    return fetch_store(values, row, p.GetUint64());
+  case NYdb::EPrimitiveType::Float:
+    return fetch_store(values, row, p.GetFloat());
+  case NYdb::EPrimitiveType::Double:
+    return fetch_store(values, row, p.GetDouble());
+  case NYdb::EPrimitiveType::Date:
+    return fetch_store<uint16_t>(values, row, p.GetDate().Days());
+  case NYdb::EPrimitiveType::Datetime:
+    return fetch_store<uint32_t>(values, row, p.GetDatetime().Seconds());
+  case NYdb::EPrimitiveType::Timestamp:
+    return fetch_store<uint64_t>(values, row, p.GetTimestamp().MicroSeconds());
+  case NYdb::EPrimitiveType::Interval:
+    return fetch_store<int64_t>(values, row, p.GetInterval());
+  default:
+    throw std::invalid_argument("unsupported fixed-width column");
+  }
+}
+
+const std::string &fetch_string(NYdb::TValueParser &p,
+                                NYdb::EPrimitiveType type) {
+  switch (type) {
+  case NYdb::EPrimitiveType::Utf8:
+    return p.GetUtf8();
+  case NYdb::EPrimitiveType::Json:
+    return p.GetJson();
+  case NYdb::EPrimitiveType::JsonDocument:
+    return p.GetJsonDocument();
+  default:
+    return p.GetString();
+  }
+}
+
+void fetch_set_valid(uint8_t *validity, size_t row, bool valid) {
+  const uint8_t bit = static_cast<uint8_t>(1u << (row % 8));
+  if (valid) {
+    validity[row / 8] |= bit;
+  } else {
+    validity[row / 8] &= static_cast<uint8_t>(~bit);
+  }
+}
+
+struct FetchColumn {
+  NYdb::EPrimitiveType type;
+  bool nullable;
+  size_t width;
+};
+
+// false if the row does not fit into a string column's data buffer
+bool fetch_row(YdbResultSet *rs, const std::vector<FetchColumn> &cols,
+               YdbColumnBuffer *out, size_t row) {
+  for (size_t i = 0; i < cols.size(); ++i) {
+    const auto &c = cols[i];
+    auto &buf = out[i];
+    auto &p = rs->parser.ColumnParser(i);
+
+    bool valid = true;
+    if (c.nullable) {
+      p.OpenOptional();
+      valid = !p.IsNull();
+    }
+    if (c.width != 0) {
+      if (valid) {
+        fetch_store_fixed(p, c.type, buf.values, row);
+      } else {
+        std::memset(static_cast<char *>(buf.values) + row * c.width, 0,
+                    c.width);
+      }
+    } else {
+      const uint32_t begin = buf.offsets[row];
+      uint32_t end = begin;
+      if (valid) {
+        const std::string &value = fetch_string(p, c.type);
+        const size_t capacity =
+            std::min<size_t>(buf.data_capacity,
+                             std::numeric_limits<uint32_t>::max());
+        if (value.size() > capacity - begin) {
+          if (c.nullable) {
+            p.CloseOptional();
+          }
+          return false;
+        }
+        std::memcpy(static_cast<char *>(buf.values) + begin, value.data(),
+                    value.size());
+        end = begin + static_cast<uint32_t>(value.size());
+      }
+      buf.offsets[row + 1] = end;
+    }
+    if (c.nullable) {
+      p.CloseOptional();
+    }
+    if (buf.validity) {
+      fetch_set_valid(buf.validity, row, valid);
+    }
+  }
+  return true;
+}
+
+// opens n sessions through the shared client; readiness is updated from the
+// SDK callbacks, and the sessions go back to the pool once all n are done
+void request_sessions(YdbDriver *drv, uint32_t n) {
+  const auto state = drv->readiness;
+  {
+    std::lock_guard lock(state->mutex);
+    state->pending += n;
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    drv->query_client->GetSession().Subscribe(
+        [state](const NYdb::NQuery::TAsyncCreateSessionResult &future) {
+          std::vector<NYdb::NQuery::TSession> done;
+          {
+            auto result = future.GetValue();
+            std::lock_guard lock(state->mutex);
+            if (result.IsSuccess()) {
+              state->ready = true;
+              state->warm.push_back(result.GetSession());
+            } else {
+              state->last_error.emplace(result);
+            }
+            if (--state->pending == 0) {
+              done.swap(state->warm);
+            }
+          }
+          state->cv.notify_all();
+        });
+  }
+}
+
+} // namespace
+
 extern "C" {
 
 struct Version {
@@ -178,6 +689,141 @@ ydb_status_t ydb_driver_config_set_auth_token(YdbDriverConfig *cfg,
   CATCH_ALL_STATUS();
 }
 
+ydb_status_t ydb_driver_config_set_session_pool_size(YdbDriverConfig *cfg,
+                                                     uint32_t min_sessions,
+                                                     uint32_t max_sessions,
+                                                     YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set session pool size");
+  }
+  // 0 keeps the SDK's maximum, which min must not exceed either
+  const uint64_t effective_max =
+      max_sessions != 0
+          ? max_sessions
+          : NYdb::NQuery::TSessionPoolSettings().MaxActiveSessions_;
+  if (min_sessions > effective_max) {
+    return RD(YDB_ERR_BAD_REQUEST,
+              "session pool minimum is greater than maximum");
+  }
+  cfg->session_pool_min = min_sessions;
+  cfg->session_pool_max = max_sessions;
+  return YDB_OK;
+}
+ydb_status_t ydb_driver_config_set_session_idle_timeout(YdbDriverConfig *cfg,
+                                                        uint32_t idle_timeout_ms,
+                                                        YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set session idle timeout");
+  }
+  cfg->session_idle_timeout_ms = idle_timeout_ms;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_driver_config_set_thread_pools(YdbDriverConfig *cfg,
+                                                uint32_t network_threads,
+                                                uint32_t client_threads,
+                                                YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set thread pools");
+  }
+  cfg->network_threads = network_threads;
+  cfg->client_threads = client_threads;
+  return YDB_OK;
+}
+ydb_status_t ydb_driver_config_set_max_client_queue_size(YdbDriverConfig *cfg,
+                                                         uint32_t size,
+                                                         YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set client queue size");
+  }
+  cfg->max_client_queue_size = size;
+  return YDB_OK;
+}
+ydb_status_t ydb_driver_config_set_grpc_keepalive(YdbDriverConfig *cfg,
+                                                  uint32_t timeout_ms,
+                                                  int permit_without_calls,
+                                                  YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set grpc keepalive");
+  }
+  cfg->grpc_keepalive_timeout_ms = timeout_ms;
+  cfg->grpc_keepalive_permit_without_calls = permit_without_calls != 0;
+  return YDB_OK;
+}
+ydb_status_t ydb_driver_config_set_max_message_size(YdbDriverConfig *cfg,
+                                                    uint64_t inbound_bytes,
+                                                    uint64_t outbound_bytes,
+                                                    YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set max message size");
+  }
+  cfg->max_inbound_message_size = inbound_bytes;
+  cfg->max_outbound_message_size = outbound_bytes;
+  return YDB_OK;
+}
+ydb_status_t ydb_driver_config_set_discovery_mode(YdbDriverConfig *cfg,
+                                                  ydb_discovery_mode_t mode,
+                                                  YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set discovery mode");
+  }
+  switch (mode) {
+  case YDB_DISCOVERY_SYNC:
+    cfg->discovery_mode = NYdb::EDiscoveryMode::Sync;
+    return YDB_OK;
+  case YDB_DISCOVERY_ASYNC:
+    cfg->discovery_mode = NYdb::EDiscoveryMode::Async;
+    return YDB_OK;
+  case YDB_DISCOVERY_OFF:
+    cfg->discovery_mode = NYdb::EDiscoveryMode::Off;
+    return YDB_OK;
+  default:
+    return RD(YDB_ERR_BAD_REQUEST, "unsupported discovery mode");
+  }
+}
+
+ydb_status_t ydb_driver_config_set_warm_sessions(YdbDriverConfig *cfg,
+                                                 uint32_t sessions,
+                                                 YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set warm sessions");
+  }
+  cfg->warm_sessions = sessions;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_driver_config_set_balancing_policy(
+    YdbDriverConfig *cfg, ydb_balancing_policy_t policy, const char *location,
+    YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!cfg) {
+    return RD(YDB_ERR_BAD_REQUEST, "failed to set balancing policy");
+  }
+  switch (policy) {
+  case YDB_BALANCING_DEFAULT:
+  case YDB_BALANCING_PREFER_LOCATION:
+  case YDB_BALANCING_PREFER_PRIMARY_PILE:
+  case YDB_BALANCING_ALL_NODES:
+    break;
+  default:
+    return RD(YDB_ERR_BAD_REQUEST, "unsupported balancing policy");
+  }
+  try {
+    cfg->balancing_policy = policy;
+    cfg->balancing_location = location ? location : "";
+    return YDB_OK;
+  }
+  CATCH_ALL_STATUS();
+}
+
 YdbDriver *ydb_driver_create(const YdbDriverConfig *cfg, YdbResultDetails *rd) {
   CHECK_RD_PTR(rd);
 
@@ -198,8 +844,64 @@ YdbDriver *ydb_driver_create(const YdbDriverConfig *cfg, YdbResultDetails *rd) {
                  .SetEndpoint(cfg->endpoint)
                  .SetDatabase(cfg->database)
                  .SetAuthToken(cfg->auth_token);
+    if (cfg->network_threads) {
+      c.SetNetworkThreadsNum(cfg->network_threads);
+    }
+    if (cfg->client_threads) {
+      c.SetClientThreadsNum(cfg->client_threads);
+    }
+    if (cfg->max_client_queue_size) {
+      c.SetMaxClientQueueSize(cfg->max_client_queue_size);
+    }
+    if (cfg->grpc_keepalive_timeout_ms) {
+      c.SetGRpcKeepAliveTimeout(
+          TDuration::MilliSeconds(cfg->grpc_keepalive_timeout_ms));
+      c.SetGRpcKeepAlivePermitWithoutCalls(
+          cfg->grpc_keepalive_permit_without_calls);
+    }
+    if (cfg->max_inbound_message_size) {
+      c.SetMaxInboundMessageSize(cfg->max_inbound_message_size);
+    }
+    if (cfg->max_outbound_message_size) {
+      c.SetMaxOutboundMessageSize(cfg->max_outbound_message_size);
+    }
+    if (cfg->discovery_mode.has_value()) {
+      c.SetDiscoveryMode(*cfg->discovery_mode);
+    }
+    switch (cfg->balancing_policy) {
+    case YDB_BALANCING_PREFER_LOCATION:
+      c.SetBalancingPolicy(NYdb::TBalancingPolicy::UsePreferableLocation(
+          cfg->balancing_location.empty()
+              ? std::nullopt
+              : std::optional<std::string>(cfg->balancing_location)));
+      break;
+    case YDB_BALANCING_PREFER_PRIMARY_PILE:
+      c.SetBalancingPolicy(NYdb::TBalancingPolicy::UsePreferablePileState());
+      break;
+    case YDB_BALANCING_ALL_NODES:
+      c.SetBalancingPolicy(NYdb::TBalancingPolicy::UseAllNodes());
+      break;
+    default:
+      break;
+    }
     drv->config = std::make_unique<NYdb::TDriverConfig>(std::move(c));
     drv->driver = std::make_unique<NYdb::TDriver>(*drv->config);
+
+    NYdb::NQuery::TSessionPoolSettings pool;
+    if (cfg->session_pool_min) {
+      pool.MinPoolSize(cfg->session_pool_min);
+    }
+    if (cfg->session_pool_max) {
+      pool.MaxActiveSessions(cfg->session_pool_max);
+    }
+    if (cfg->session_idle_timeout_ms) {
+      pool.CloseIdleThreshold(
+          TDuration::MilliSeconds(cfg->session_idle_timeout_ms));
+    }
+    drv->query_client_settings.SessionPoolSettings(pool);
+    drv->query_client = std::make_unique<NYdb::NQuery::TQueryClient>(
+        *drv->driver, drv->query_client_settings);
+    drv->warm_sessions = cfg->warm_sessions;
   } catch (const std::exception &e) {
     ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
     delete drv;
@@ -210,10 +912,21 @@ YdbDriver *ydb_driver_create(const YdbDriverConfig *cfg, YdbResultDetails *rd) {
 
 ydb_status_t ydb_driver_start(YdbDriver *drv, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!drv) {
+  if (!drv || !drv->query_client) {
     return RD(YDB_ERR_BAD_REQUEST, "driver is null");
   }
-  return YDB_OK;
+  try {
+    {
+      std::lock_guard lock(drv->readiness->mutex);
+      if (drv->readiness->started) {
+        return YDB_OK;
+      }
+      drv->readiness->started = true;
+    }
+    request_sessions(drv, std::max<uint32_t>(drv->warm_sessions, 1));
+    return YDB_OK;
+  }
+  CATCH_ALL_STATUS();
 }
 
 ydb_status_t ydb_driver_wait_ready(YdbDriver *drv, uint32_t timeout_ms,
@@ -222,35 +935,94 @@ ydb_status_t ydb_driver_wait_ready(YdbDriver *drv, uint32_t timeout_ms,
   if (!drv) {
     return RD(YDB_ERR_BAD_REQUEST, "driver is null");
   }
-  if (!drv->driver) {
+  if (!drv->driver || !drv->query_client) {
     return RD(YDB_ERR_BAD_REQUEST, "driver handle is not initialized");
   }
 
   try {
-    auto query_client = NYdb::NQuery::TQueryClient(*drv->driver);
-    const auto started = std::chrono::steady_clock::now();
-    const auto timeout = std::chrono::milliseconds(timeout_ms);
+    const ydb_status_t started = ydb_driver_start(drv, rd);
+    if (started != YDB_OK) {
+      return started;
+    }
 
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms);
+    std::chrono::milliseconds backoff(10);
+    auto &state = *drv->readiness;
+    std::unique_lock lock(state.mutex);
     for (;;) {
-      auto session_result = query_client.GetSession().GetValueSync();
-      if (session_result.IsSuccess()) {
+      // wakes on the first session or once every request has failed
+      state.cv.wait_until(lock, deadline,
+                          [&] { return state.ready || state.pending == 0; });
+      if (state.ready) {
         return YDB_OK;
       }
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
+      }
+      if (state.pending == 0) {
+        // only a failed round waits before trying again
+        lock.unlock();
+        std::this_thread::sleep_for(std::min(
+            backoff, std::chrono::duration_cast<std::chrono::milliseconds>(
+                         deadline - now)));
+        backoff = std::min(backoff * 2, std::chrono::milliseconds(500));
+        request_sessions(drv, 1);
+        lock.lock();
+      }
+    }
 
-      (void)ydb_fill_from_status(rd, session_result);
+    // the SDK's own failure says more than the timeout does
+    const auto failure = state.last_error;
+    lock.unlock();
+    if (failure.has_value()) {
+      return ydb_fill_from_status(rd, *failure);
+    }
+    const std::string timeout_msg = "driver is not ready before timeout (" +
+                                    std::to_string(timeout_ms) + " ms)";
+    return RD(YDB_ERR_TIMEOUT, timeout_msg.c_str());
+  }
+  CATCH_ALL_STATUS();
+}
 
-      const auto elapsed = std::chrono::steady_clock::now() - started;
-      if (elapsed >= timeout) {
-        const std::string timeout_msg = "driver is not ready before timeout (" +
-                                        std::to_string(timeout_ms) + " ms)";
-        return ydb_result_details_fail(rd, YDB_ERR_TIMEOUT, timeout_msg.c_str());
-      }
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+ydb_status_t ydb_driver_list_endpoints(YdbDriver *drv,
+                                       YdbEndpointList **out_list,
+                                       const YdbEndpointInfo **out_items,
+                                       size_t *out_count,
+                                       YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!drv || !drv->driver || !out_list || !out_items || !out_count) {
+    return RD(YDB_ERR_BAD_REQUEST, "invalid list endpoints arguments");
+  }
+  *out_list = nullptr;
+  *out_items = nullptr;
+  *out_count = 0;
+  try {
+    NYdb::NDiscovery::TDiscoveryClient discovery(*drv->driver);
+    auto result = discovery.ListEndpoints().ExtractValueSync();
+    if (!result.IsSuccess()) {
+      return ydb_fill_from_status(rd, result);
+    }
+
+    auto list = std::make_unique<YdbEndpointList>();
+    list->endpoints = result.GetEndpointsInfo();
+    list->items.reserve(list->endpoints.size());
+    for (const auto &endpoint : list->endpoints) {
+      list->items.push_back({endpoint.Address.c_str(), endpoint.Port,
+                             endpoint.Location.c_str(), endpoint.NodeId,
+                             endpoint.LoadFactor});
     }
+    *out_items = list->items.data();
+    *out_count = list->items.size();
+    *out_list = list.release();
+    return YDB_OK;
   }
   CATCH_ALL_STATUS();
 }
 
+void ydb_endpoint_list_free(YdbEndpointList *list) { delete list; }
+
 void ydb_driver_free(YdbDriver *drv) {
   try {
     if (!drv) {
@@ -290,6 +1062,18 @@ void ydb_query_params_free(YdbQueryParams *p, YdbResultDetails *rd) {
   }
 }
 
+ydb_status_t ydb_query_params_reset(YdbQueryParams *p, YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!p) {
+    return RD(YDB_ERR_BAD_REQUEST, "query params is null");
+  }
+  for (auto &slot : p->values) {
+    slot.second.reset();
+  }
+  p->built.reset();
+  return YDB_OK;
+}
+
 ydb_status_t ydb_params_set_utf8(YdbQueryParams *p, const char *name,
                                  const char *value, YdbResultDetails *rd) {
   CHECK_RD(rd);
@@ -297,7 +1081,7 @@ ydb_status_t ydb_params_set_utf8(YdbQueryParams *p, const char *name,
     return RD(YDB_ERR_BAD_REQUEST, "invalid utf8 parameter");
   }
   try {
-    p->builder.AddParam(name).Utf8(value).Build();
+    ydb_query_params_store(p, name, NYdb::TValueBuilder().Utf8(value).Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -309,7 +1093,7 @@ ydb_status_t ydb_params_set_int64(YdbQueryParams *p, const char *name,
     return RD(YDB_ERR_BAD_REQUEST, "invalid int64 parameter");
   }
   try {
-    p->builder.AddParam(name).Int64(value).Build();
+    ydb_query_params_store(p, name, NYdb::TValueBuilder().Int64(value).Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -321,7 +1105,7 @@ ydb_status_t ydb_params_set_uint64(YdbQueryParams *p, const char *name,
     return RD(YDB_ERR_BAD_REQUEST, "invalid uint64 parameter");
   }
   try {
-    p->builder.AddParam(name).Uint64(value).Build();
+    ydb_query_params_store(p, name, NYdb::TValueBuilder().Uint64(value).Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -333,7 +1117,7 @@ ydb_status_t ydb_params_set_double(YdbQueryParams *p, const char *name,
     return RD(YDB_ERR_BAD_REQUEST, "invalid double parameter");
   }
   try {
-    p->builder.AddParam(name).Double(value).Build();
+    ydb_query_params_store(p, name, NYdb::TValueBuilder().Double(value).Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -345,7 +1129,7 @@ ydb_status_t ydb_params_set_bool(YdbQueryParams *p, const char *name, int value,
     return RD(YDB_ERR_BAD_REQUEST, "invalid bool parameter");
   }
   try {
-    p->builder.AddParam(name).Bool(value != 0).Build();
+    ydb_query_params_store(p, name, NYdb::TValueBuilder().Bool(value != 0).Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -358,9 +1142,11 @@ ydb_status_t ydb_params_set_bytes(YdbQueryParams *p, const char *name,
     return RD(YDB_ERR_BAD_REQUEST, "invalid bytes parameter");
   }
   try {
-    p->builder.AddParam(name)
-        .String(std::string(static_cast<const char *>(data), len))
-        .Build();
+    ydb_query_params_store(
+        p, name,
+        NYdb::TValueBuilder()
+            .String(std::string(static_cast<const char *>(data), len))
+            .Build());
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -374,9 +1160,9 @@ YdbParamBuilder *ydb_params_begin_param(YdbQueryParams *p, const char *name,
     return nullptr;
   }
   try {
-    auto b = std::make_unique<YdbParamBuilder>();
+    YdbArenaPtr<YdbParamBuilder> b(ydb_arena_new<YdbParamBuilder>());
     b->owner = p;
-    b->slot = &p->builder.AddParam(name);
+    b->name = name;
     return b.release();
   }
   CATCH_ALL_PTR(rd);
@@ -388,8 +1174,8 @@ ydb_status_t ydb_params_end_param(YdbParamBuilder *b, YdbResultDetails *rd) {
     return RD(YDB_ERR_BAD_REQUEST, "param builder is null");
   }
   try {
-    b->slot->Build();
-    delete b;
+    ydb_query_params_store(b->owner, b->name, b->value.Build());
+    ydb_arena_delete(b);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -397,11 +1183,11 @@ ydb_status_t ydb_params_end_param(YdbParamBuilder *b, YdbResultDetails *rd) {
 
 ydb_status_t ydb_params_begin_list(YdbParamBuilder *b, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->BeginList();
+    b->value.BeginList();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -410,11 +1196,11 @@ ydb_status_t ydb_params_begin_list(YdbParamBuilder *b, YdbResultDetails *rd) {
 ydb_status_t ydb_params_add_list_item(YdbParamBuilder *b,
                                       YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem();
+    b->value.AddListItem();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -423,11 +1209,11 @@ ydb_status_t ydb_params_add_list_item(YdbParamBuilder *b,
 ydb_status_t ydb_params_add_list_item_bool(YdbParamBuilder *b, int v,
                                            YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Bool(v != 0);
+    b->value.AddListItem().Bool(v != 0);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -436,11 +1222,11 @@ ydb_status_t ydb_params_add_list_item_bool(YdbParamBuilder *b, int v,
 ydb_status_t ydb_params_add_list_item_int32(YdbParamBuilder *b, int32_t v,
                                             YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Int32(v);
+    b->value.AddListItem().Int32(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -449,11 +1235,11 @@ ydb_status_t ydb_params_add_list_item_int32(YdbParamBuilder *b, int32_t v,
 ydb_status_t ydb_params_add_list_item_uint32(YdbParamBuilder *b, uint32_t v,
                                              YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Uint32(v);
+    b->value.AddListItem().Uint32(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -462,11 +1248,11 @@ ydb_status_t ydb_params_add_list_item_uint32(YdbParamBuilder *b, uint32_t v,
 ydb_status_t ydb_params_add_list_item_int64(YdbParamBuilder *b, int64_t v,
                                             YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Int64(v);
+    b->value.AddListItem().Int64(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -475,11 +1261,11 @@ ydb_status_t ydb_params_add_list_item_int64(YdbParamBuilder *b, int64_t v,
 ydb_status_t ydb_params_add_list_item_uint64(YdbParamBuilder *b, uint64_t v,
                                              YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Uint64(v);
+    b->value.AddListItem().Uint64(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -488,11 +1274,11 @@ ydb_status_t ydb_params_add_list_item_uint64(YdbParamBuilder *b, uint64_t v,
 ydb_status_t ydb_params_add_list_item_float(YdbParamBuilder *b, float v,
                                             YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Float(v);
+    b->value.AddListItem().Float(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -501,11 +1287,11 @@ ydb_status_t ydb_params_add_list_item_float(YdbParamBuilder *b, float v,
 ydb_status_t ydb_params_add_list_item_double(YdbParamBuilder *b, double v,
                                              YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().Double(v);
+    b->value.AddListItem().Double(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -514,7 +1300,7 @@ ydb_status_t ydb_params_add_list_item_double(YdbParamBuilder *b, double v,
 ydb_status_t ydb_params_add_list_item_utf8(YdbParamBuilder *b, const char *v,
                                            YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot || !v) {
+  if (!b || !v) {
     return RD(YDB_ERR_BAD_REQUEST, "invalid utf8 list item");
   }
   constexpr size_t kMaxUtf8Len = 1U << 20; // 1 MiB safety bound
@@ -526,7 +1312,7 @@ ydb_status_t ydb_params_add_list_item_utf8(YdbParamBuilder *b, const char *v,
   try {
     const size_t len =
         static_cast<size_t>(static_cast<const char *>(terminator) - v);
-    b->slot->AddListItem().Utf8(std::string(v, len));
+    b->value.AddListItem().Utf8(std::string(v, len));
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -536,11 +1322,11 @@ ydb_status_t ydb_params_add_list_item_bytes(YdbParamBuilder *b,
                                             const void *data, size_t len,
                                             YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot || !data) {
+  if (!b || !data) {
     return RD(YDB_ERR_BAD_REQUEST, "invalid bytes list item");
   }
   try {
-    b->slot->AddListItem().String(
+    b->value.AddListItem().String(
         std::string(static_cast<const char *>(data), len));
     return YDB_OK;
   }
@@ -550,11 +1336,11 @@ ydb_status_t ydb_params_add_list_item_bytes(YdbParamBuilder *b,
 ydb_status_t ydb_params_add_list_item_null(YdbParamBuilder *b,
                                            YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->AddListItem().EmptyOptional();
+    b->value.AddListItem().EmptyOptional();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -562,11 +1348,11 @@ ydb_status_t ydb_params_add_list_item_null(YdbParamBuilder *b,
 
 ydb_status_t ydb_params_end_list(YdbParamBuilder *b, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "list builder is null");
   }
   try {
-    b->slot->EndList();
+    b->value.EndList();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -574,11 +1360,11 @@ ydb_status_t ydb_params_end_list(YdbParamBuilder *b, YdbResultDetails *rd) {
 
 ydb_status_t ydb_params_begin_struct(YdbParamBuilder *b, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "struct builder is null");
   }
   try {
-    b->slot->BeginStruct();
+    b->value.BeginStruct();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -586,11 +1372,11 @@ ydb_status_t ydb_params_begin_struct(YdbParamBuilder *b, YdbResultDetails *rd) {
 
 ydb_status_t ydb_params_end_struct(YdbParamBuilder *b, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!b || !b->slot) {
+  if (!b) {
     return RD(YDB_ERR_BAD_REQUEST, "struct builder is null");
   }
   try {
-    b->slot->EndStruct();
+    b->value.EndStruct();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -603,7 +1389,7 @@ ydb_status_t ydb_params_add_member_bool(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid bool member");
   }
   try {
-    b->slot->AddMember(field).Bool(v != 0);
+    b->value.AddMember(field).Bool(v != 0);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -615,7 +1401,7 @@ ydb_status_t ydb_params_add_member_int32(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid int32 member");
   }
   try {
-    b->slot->AddMember(field).Int32(v);
+    b->value.AddMember(field).Int32(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -627,7 +1413,7 @@ ydb_status_t ydb_params_add_member_uint32(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid uint32 member");
   }
   try {
-    b->slot->AddMember(field).Uint32(v);
+    b->value.AddMember(field).Uint32(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -639,7 +1425,7 @@ ydb_status_t ydb_params_add_member_int64(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid int64 member");
   }
   try {
-    b->slot->AddMember(field).Int64(v);
+    b->value.AddMember(field).Int64(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -651,7 +1437,7 @@ ydb_status_t ydb_params_add_member_uint64(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid uint64 member");
   }
   try {
-    b->slot->AddMember(field).Uint64(v);
+    b->value.AddMember(field).Uint64(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -663,7 +1449,7 @@ ydb_status_t ydb_params_add_member_float(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid float member");
   }
   try {
-    b->slot->AddMember(field).Float(v);
+    b->value.AddMember(field).Float(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -675,7 +1461,7 @@ ydb_status_t ydb_params_add_member_double(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid double member");
   }
   try {
-    b->slot->AddMember(field).Double(v);
+    b->value.AddMember(field).Double(v);
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -696,7 +1482,7 @@ ydb_status_t ydb_params_add_member_utf8(YdbParamBuilder *b, const char *field,
   try {
     const size_t len =
         static_cast<size_t>(static_cast<const char *>(terminator) - v);
-    b->slot->AddMember(field).Utf8(std::string(v, len));
+    b->value.AddMember(field).Utf8(std::string(v, len));
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -709,7 +1495,7 @@ ydb_status_t ydb_params_add_member_bytes(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid bytes member");
   }
   try {
-    b->slot->AddMember(field).String(
+    b->value.AddMember(field).String(
         std::string(static_cast<const char *>(data), len));
     return YDB_OK;
   }
@@ -722,7 +1508,73 @@ ydb_status_t ydb_params_add_member_null(YdbParamBuilder *b, const char *field,
     return RD(YDB_ERR_BAD_REQUEST, "invalid null member");
   }
   try {
-    b->slot->AddMember(field).EmptyOptional();
+    b->value.AddMember(field).EmptyOptional();
+    return YDB_OK;
+  }
+  CATCH_ALL_STATUS();
+}
+
+ydb_status_t ydb_params_bind_struct_list(YdbParamBuilder *b, size_t n_rows,
+                                         size_t n_cols,
+                                         const YdbColumnBinding *cols,
+                                         YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!b || n_cols == 0 || !cols) {
+    return RD(YDB_ERR_BAD_REQUEST, "invalid struct list binding");
+  }
+  for (size_t i = 0; i < n_cols; ++i) {
+    const auto &c = cols[i];
+    if (!c.name || !binding_primitive(c.type)) {
+      return RD(YDB_ERR_BAD_REQUEST, "invalid column binding name or type");
+    }
+    const bool is_string = c.type == YDB_TYPE_UTF8 || c.type == YDB_TYPE_BYTES;
+    if (n_rows > 0 && (!c.values || (is_string && !c.offsets))) {
+      return RD(YDB_ERR_BAD_REQUEST, "column binding has no data");
+    }
+    if (is_string && n_rows > 0 && !binding_offsets_valid(c, n_rows)) {
+      return RD(YDB_ERR_BAD_REQUEST, "column offsets must not decrease");
+    }
+  }
+  try {
+    // member names are converted once, not once per cell
+    std::vector<std::string> names;
+    names.reserve(n_cols);
+    for (size_t i = 0; i < n_cols; ++i) {
+      names.emplace_back(cols[i].name);
+    }
+    // everything the builder could reject is checked before it is touched:
+    // a throw after BeginList would leave it open and poison the param
+    if (std::set<std::string_view>(names.begin(), names.end()).size() !=
+        n_cols) {
+      return RD(YDB_ERR_BAD_REQUEST, "duplicate column binding name");
+    }
+
+    if (n_rows == 0) {
+      NYdb::TTypeBuilder type;
+      type.BeginStruct();
+      for (size_t i = 0; i < n_cols; ++i) {
+        type.AddMember(names[i]);
+        if (cols[i].validity) {
+          type.BeginOptional().Primitive(*binding_primitive(cols[i].type))
+              .EndOptional();
+        } else {
+          type.Primitive(*binding_primitive(cols[i].type));
+        }
+      }
+      type.EndStruct();
+      b->value.EmptyList(type.Build());
+      return YDB_OK;
+    }
+
+    b->value.BeginList();
+    for (size_t row = 0; row < n_rows; ++row) {
+      b->value.AddListItem().BeginStruct();
+      for (size_t i = 0; i < n_cols; ++i) {
+        bind_member(b->value, names[i], cols[i], row);
+      }
+      b->value.EndStruct();
+    }
+    b->value.EndList();
     return YDB_OK;
   }
   CATCH_ALL_STATUS();
@@ -744,7 +1596,10 @@ YdbResultSet *ydb_resultsets_release(YdbResultSets *rs, int index,
   }
   return rs->sets[static_cast<size_t>(index)].release();
 }
-void ydb_resultsets_free(YdbResultSets *rs, YdbResultDetails *rd) { delete rs; }
+void ydb_resultsets_free(YdbResultSets *rs, YdbResultDetails *rd) {
+  ydb_arena_delete(rs);
+}
+void ydb_resultset_free(YdbResultSet *rs) { ydb_arena_delete(rs); }
 int ydb_resultset_column_count(const YdbResultSet *rs, YdbResultDetails *rd) {
   CHECK_RD_INT(rd, -1);
   if (!rs) {
@@ -767,38 +1622,40 @@ const char *ydb_resultset_column_name(const YdbResultSet *rs, int col_index,
 
 ydb_type_t ydb_resultset_column_type(const YdbResultSet *rs, int col_index,
                                      YdbResultDetails *rd) {
-  try {
-    if (!rs || col_index < 0 || col_index >= rs->parser.ColumnsCount())
-      return YDB_TYPE_UNKNOWN;
-
-    const auto &type = rs->resultSet.GetColumnsMeta()[col_index].Type;
-    NYdb::TTypeParser parser(type);
-
-    if (parser.GetKind() == NYdb::TTypeParser::ETypeKind::Optional) {
-      parser.OpenOptional();
-      return YDB_TYPE_OPTIONAL;
-    }
-
-    if (parser.GetKind() == NYdb::TTypeParser::ETypeKind::Primitive)
-      return static_cast<ydb_type_t>(
-          static_cast<uint32_t>(parser.GetPrimitive()));
-
+  if (!rs || col_index < 0 ||
+      static_cast<size_t>(col_index) >= rs->schema.size()) {
     return YDB_TYPE_UNKNOWN;
   }
-  CATCH_ALL_INT(rd, YDB_TYPE_UNKNOWN);
+  const auto &info = rs->schema[static_cast<size_t>(col_index)];
+  return info.nullable ? YDB_TYPE_OPTIONAL : info.type;
+}
+
+ydb_status_t ydb_resultset_schema(const YdbResultSet *rs,
+                                  const YdbColumnInfo **out, int *n,
+                                  YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!rs || !out || !n) {
+    return RD(YDB_ERR_BAD_REQUEST, "invalid schema arguments");
+  }
+  *out = rs->schema.data();
+  *n = static_cast<int>(rs->schema.size());
+  return YDB_OK;
 }
 int ydb_resultset_next_row(YdbResultSet *rs, YdbResultDetails *rd) {
   CHECK_RD_INT(rd, -1);
   if (!rs) {
     return RD(YDB_ERR_BAD_REQUEST, "result set is null");
   }
-  return rs->parser.TryNextRow() ? 1 : 0;
+  return rs->advance() ? 1 : 0;
 }
 int ydb_resultset_is_null(YdbResultSet *rs, int col, YdbResultDetails *rd) {
   CHECK_RD_INT(rd, -1);
-  if (!rs || col < 0 || col >= static_cast<int>(rs->parser.ColumnsCount())) {
+  if (!rs || col < 0 || static_cast<size_t>(col) >= rs->schema.size()) {
     return RD(YDB_ERR_BAD_REQUEST, "invalid column index");
   }
+  if (!rs->schema[static_cast<size_t>(col)].nullable) {
+    return 0;
+  }
   try {
     return rs->parser.ColumnParser(static_cast<size_t>(col)).IsNull() ? 1 : 0;
   } catch (const std::exception &e) {
@@ -806,124 +1663,342 @@ int ydb_resultset_is_null(YdbResultSet *rs, int col, YdbResultDetails *rd) {
   }
 }
 
+ydb_status_t ydb_resultset_get_value(YdbResultSet *rs, int col, YdbValue *out,
+                                     YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  if (!out) {
+    return RD(YDB_ERR_BAD_REQUEST, "output pointer is null");
+  }
+  return read_value(rs, col, out, rd);
+}
+
 ydb_status_t ydb_resultset_get_utf8(YdbResultSet *rs, int col, const char **out,
                                     size_t *out_len, YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || !out_len || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid utf8 getter arguments");
-  }
-  try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalUtf8();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
-    }
-    rs->scratch = *value;
-    *out = rs->scratch.c_str();
-    *out_len = rs->scratch.size();
-    return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
+  return get_view(rs, col, true, out, out_len, rd);
+}
+ydb_status_t ydb_resultset_get_bytes(YdbResultSet *rs, int col,
+                                     const void **out, size_t *out_len,
+                                     YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  const char *data = nullptr;
+  const ydb_status_t st = get_view(rs, col, false, &data, out_len, rd);
+  if (st == YDB_OK) {
+    *out = data;
   }
+  return st;
+}
+ydb_status_t ydb_resultset_get_bool(YdbResultSet *rs, int col, int *out,
+                                    YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not bool",
+      [](const YdbValue &v, int *o) {
+        *o = v.value.boolean;
+        return v.type == YDB_TYPE_BOOL;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_int32(YdbResultSet *rs, int col, int32_t *out,
+                                     YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column does not fit int32",
+      [](const YdbValue &v, int32_t *o) {
+        if (is_signed_int(v.type) && v.type != YDB_TYPE_INT64) {
+          *o = static_cast<int32_t>(v.value.i64);
+          return true;
+        }
+        *o = static_cast<int32_t>(v.value.u64);
+        return v.type == YDB_TYPE_UINT8 || v.type == YDB_TYPE_UINT16;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_uint32(YdbResultSet *rs, int col, uint32_t *out,
+                                      YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column does not fit uint32",
+      [](const YdbValue &v, uint32_t *o) {
+        *o = static_cast<uint32_t>(v.value.u64);
+        return is_unsigned_int(v.type) && v.type != YDB_TYPE_UINT64;
+      },
+      rd);
 }
 ydb_status_t ydb_resultset_get_int64(YdbResultSet *rs, int col, int64_t *out,
                                      YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid int64 getter arguments");
-  }
-  try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalInt64();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
-    }
-    *out = *value;
-    return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
-  }
+  return get_scalar(
+      rs, col, out, "column does not fit int64",
+      [](const YdbValue &v, int64_t *o) {
+        if (is_signed_int(v.type)) {
+          *o = v.value.i64;
+          return true;
+        }
+        *o = static_cast<int64_t>(v.value.u64);
+        return is_unsigned_int(v.type) && v.type != YDB_TYPE_UINT64;
+      },
+      rd);
 }
 ydb_status_t ydb_resultset_get_uint64(YdbResultSet *rs, int col, uint64_t *out,
                                       YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid uint64 getter arguments");
-  }
-  try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalUint64();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
-    }
-    *out = *value;
-    return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
-  }
+  return get_scalar(
+      rs, col, out, "column does not fit uint64",
+      [](const YdbValue &v, uint64_t *o) {
+        *o = v.value.u64;
+        return is_unsigned_int(v.type);
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_float(YdbResultSet *rs, int col, float *out,
+                                     YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not float",
+      [](const YdbValue &v, float *o) {
+        *o = v.value.f32;
+        return v.type == YDB_TYPE_FLOAT;
+      },
+      rd);
 }
 ydb_status_t ydb_resultset_get_double(YdbResultSet *rs, int col, double *out,
                                       YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid double getter arguments");
-  }
-  try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalDouble();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
-    }
-    *out = *value;
-    return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
-  }
+  return get_scalar(
+      rs, col, out, "column does not fit double",
+      [](const YdbValue &v, double *o) {
+        *o = v.type == YDB_TYPE_FLOAT ? v.value.f32 : v.value.f64;
+        return v.type == YDB_TYPE_FLOAT || v.type == YDB_TYPE_DOUBLE;
+      },
+      rd);
 }
-ydb_status_t ydb_resultset_get_bool(YdbResultSet *rs, int col, int *out,
+ydb_status_t ydb_resultset_get_date(YdbResultSet *rs, int col, uint32_t *out,
+                                    YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not date",
+      [](const YdbValue &v, uint32_t *o) {
+        *o = static_cast<uint32_t>(v.value.u64);
+        return v.type == YDB_TYPE_DATE;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_datetime(YdbResultSet *rs, int col,
+                                        uint32_t *out, YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not datetime",
+      [](const YdbValue &v, uint32_t *o) {
+        *o = static_cast<uint32_t>(v.value.u64);
+        return v.type == YDB_TYPE_DATETIME;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_timestamp(YdbResultSet *rs, int col,
+                                         uint64_t *out, YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not timestamp",
+      [](const YdbValue &v, uint64_t *o) {
+        *o = v.value.u64;
+        return v.type == YDB_TYPE_TIMESTAMP;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_interval(YdbResultSet *rs, int col,
+                                        int64_t *out, YdbResultDetails *rd) {
+  CHECK_RD(rd);
+  return get_scalar(
+      rs, col, out, "column is not interval",
+      [](const YdbValue &v, int64_t *o) {
+        *o = v.value.i64;
+        return v.type == YDB_TYPE_INTERVAL;
+      },
+      rd);
+}
+ydb_status_t ydb_resultset_get_uuid(YdbResultSet *rs, int col, uint8_t *out,
                                     YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid bool getter arguments");
+  if (!out) {
+    return RD(YDB_ERR_BAD_REQUEST, "output pointer is null");
   }
-  try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalBool();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
-    }
-    *out = *value ? 1 : 0;
-    return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
+  YdbValue v;
+  if (const ydb_status_t st = read_value(rs, col, &v, rd); st != YDB_OK) {
+    return st;
+  }
+  if (v.type != YDB_TYPE_UUID) {
+    return RD(YDB_ERR_BAD_REQUEST, "column is not uuid");
   }
+  if (v.is_null) {
+    return RD(YDB_ERR_NOT_FOUND, "column value is null");
+  }
+  std::memcpy(out, v.value.uuid, sizeof(v.value.uuid));
+  return YDB_OK;
 }
-ydb_status_t ydb_resultset_get_bytes(YdbResultSet *rs, int col,
-                                     const void **out, size_t *out_len,
-                                     YdbResultDetails *rd) {
+
+ydb_status_t ydb_resultset_fetch_columns(YdbResultSet *rs, size_t max_rows,
+                                         YdbColumnBuffer *out,
+                                         size_t *rows_fetched,
+                                         YdbResultDetails *rd) {
   CHECK_RD(rd);
-  if (!rs || !out || !out_len || col < 0 ||
-      col >= static_cast<int>(rs->parser.ColumnsCount())) {
-    return RD(YDB_ERR_BAD_REQUEST, "invalid bytes getter arguments");
+  if (!rs || !out || !rows_fetched) {
+    return RD(YDB_ERR_BAD_REQUEST, "invalid columnar fetch arguments");
   }
+  *rows_fetched = 0;
   try {
-    auto value =
-        rs->parser.ColumnParser(static_cast<size_t>(col)).GetOptionalBytes();
-    if (!value.has_value()) {
-      return RD(YDB_ERR_NOT_FOUND, "column value is null");
+    std::vector<FetchColumn> cols;
+    cols.reserve(rs->schema.size());
+    for (size_t i = 0; i < rs->schema.size(); ++i) {
+      const auto &info = rs->schema[i];
+      const bool nullable = info.nullable != 0;
+      const std::optional<NYdb::EPrimitiveType> type =
+          info.type == YDB_TYPE_UNKNOWN || info.type == YDB_TYPE_DECIMAL
+              ? std::nullopt
+              : std::optional(static_cast<NYdb::EPrimitiveType>(info.type));
+      if (!type || (fetch_width(*type) == 0 && !fetch_is_string(*type))) {
+        return RD(YDB_ERR_BAD_REQUEST, "column type has no columnar layout");
+      }
+      auto &buf = out[i];
+      const size_t width = fetch_width(*type);
+      if (!buf.values || (width == 0 && !buf.offsets) ||
+          (nullable && !buf.validity)) {
+        return RD(YDB_ERR_BAD_REQUEST, "column buffer is incomplete");
+      }
+      buf.type = info.type;
+      buf.data_len = 0;
+      buf.null_count = 0;
+      if (width == 0) {
+        buf.offsets[0] = 0;
+      }
+      cols.push_back({*type, nullable, width});
+    }
+
+    size_t row = 0;
+    while (row < max_rows) {
+      if (!rs->advance()) {
+        break;
+      }
+      if (!fetch_row(rs, cols, out, row)) {
+        rs->row_pending = true;
+        if (row == 0) {
+          return RD(YDB_ERR_BUFFER_TOO_SMALL,
+                    "row does not fit into the column buffers");
+        }
+        break;
+      }
+      ++row;
     }
-    rs->scratch = *value;
-    *out = rs->scratch.data();
-    *out_len = rs->scratch.size();
+
+    for (size_t i = 0; i < cols.size(); ++i) {
+      auto &buf = out[i];
+      if (cols[i].width == 0) {
+        buf.data_len = buf.offsets[row];
+      }
+      if (cols[i].nullable) {
+        for (size_t r = 0; r < row; ++r) {
+          if (((buf.validity[r / 8] >> (r % 8)) & 1) == 0) {
+            ++buf.null_count;
+          }
+        }
+      }
+    }
+    *rows_fetched = row;
     return YDB_OK;
-  } catch (const std::exception &e) {
-    return RD(YDB_ERR_INTERNAL, e.what());
+  } catch (const std::invalid_argument &e) {
+    return RD(YDB_ERR_BAD_REQUEST, e.what());
   }
+  CATCH_ALL_STATUS();
 }
 
 } // extern "C"
+
+YdbResultSet::YdbResultSet(NYdb::TResultSet rs)
+    : resultSet(std::move(rs)), parser(resultSet) {
+  const auto &meta = resultSet.GetColumnsMeta();
+  schema.reserve(meta.size());
+  for (const auto &column : meta) {
+    YdbColumnInfo info{};
+    info.name = column.Name.c_str();
+    info.type = YDB_TYPE_UNKNOWN;
+
+    NYdb::TTypeParser type(column.Type);
+    if (type.GetKind() == NYdb::TTypeParser::ETypeKind::Optional) {
+      type.OpenOptional();
+      info.nullable = 1;
+    }
+    switch (type.GetKind()) {
+    case NYdb::TTypeParser::ETypeKind::Primitive:
+      info.type = static_cast<ydb_type_t>(
+          static_cast<uint32_t>(type.GetPrimitive()));
+      break;
+    case NYdb::TTypeParser::ETypeKind::Decimal: {
+      const auto decimal = type.GetDecimal();
+      info.type = YDB_TYPE_DECIMAL;
+      info.decimal_precision = decimal.Precision;
+      info.decimal_scale = decimal.Scale;
+      break;
+    }
+    default:
+      break;
+    }
+    schema.push_back(info);
+  }
+}
+
+bool YdbResultSet::advance() {
+  if (row_pending) {
+    row_pending = false;
+    return true;
+  }
+  if (tracer && !iteration) {
+    const std::string rows = std::to_string(resultSet.RowsCount());
+    iteration.emplace(tracer, "ydb.ResultSet.iterate",
+                      std::initializer_list<YdbSpanAttribute>{
+                          {"db.system", "ydb"},
+                          {"db.response.returned_rows", rows.c_str()}});
+  }
+  if (parser.TryNextRow()) {
+    ++rows_read;
+    return true;
+  }
+  if (iteration) {
+    iteration->end(YDB_OK);
+  }
+  return false;
+}
+
+void ydb_query_params_store(YdbQueryParams *p, std::string_view name,
+                            NYdb::TValue value) {
+  auto it = p->values.find(name);
+  if (it == p->values.end()) {
+    p->values.emplace(std::string(name), std::move(value));
+  } else {
+    it->second = std::move(value);
+  }
+  p->built.reset();
+}
+
+const NYdb::TParams &ydb_query_params_get(const YdbQueryParams *p) {
+  if (!p->built.has_value()) {
+    NYdb::TParamsBuilder builder;
+    for (const auto &[name, value] : p->values) {
+      // unset slots are left out; the server treats a missing Optional
+      // parameter as NULL and rejects any other
+      if (value.has_value()) {
+        builder.AddParam(name, *value);
+      }
+    }
+    p->built.emplace(builder.Build());
+  }
+  return *p->built;
+}
+
+const NYdb::TValue *ydb_query_params_find(const YdbQueryParams *p,
+                                          std::string_view name) {
+  auto it = p->values.find(name);
+  if (it == p->values.end() || !it->second.has_value()) {
+    return nullptr;
+  }
+  return &*it->second;
+}
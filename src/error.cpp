@@ -3,51 +3,109 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <new>
 #include <string>
 
 #include <ydb-cpp-sdk/client/types/status_codes.h>
 
-namespace {} // namespace
+namespace {
+
+void invalidate_message(YdbResultDetails *d) {
+  d->message_ready = false;
+  d->message.clear();
+}
+
+void set_text(YdbResultDetails *d, const char *msg) {
+  if (d->codes_only || !msg) {
+    d->text[0] = '\0';
+    return;
+  }
+  std::strncpy(d->text, msg, YdbResultDetails::kTextSize - 1);
+  d->text[YdbResultDetails::kTextSize - 1] = '\0';
+}
+
+void clear_failure(YdbResultDetails *d) {
+  d->text[0] = '\0';
+  d->status.reset();
+  d->trail_size = 0;
+  invalidate_message(d);
+}
+
+} // namespace
 
 extern "C" {
 
-int ydb_result_details_init(YdbResultDetails *d) {
+YdbResultDetails *ydb_result_details_create(int codes_only) {
+  auto *d = new (std::nothrow) YdbResultDetails();
+  if (d) {
+    d->codes_only = codes_only != 0;
+  }
+  return d;
+}
 
-  try {
-    d = new YdbResultDetails;
-    d->code = 0;
-    d->message = std::string();
-    d->context = std::string();
-    return 0;
-  } catch(...) {
+int ydb_result_details_init(YdbResultDetails **out) {
+  if (!out) {
     return -1;
   }
+  *out = ydb_result_details_create(0);
+  return *out ? 0 : -1;
+}
+
+YdbResultDetails *ydb_result_details_thread_local(void) {
+  thread_local YdbResultDetails details;
+  details.thread_owned = true;
+  return &details;
 }
 
 void ydb_result_details_reset(YdbResultDetails *d) {
   if (!d) {
     return;
   }
-  d->message.clear();
+  d->code = YDB_OK;
+  d->sdk_status = 0;
   d->context.clear();
+  clear_failure(d);
 }
 
 void ydb_result_details_free(YdbResultDetails *d) {
-  if (!d) {
+  if (!d || d->thread_owned) {
     return;
   }
   delete d;
 }
 
+ydb_status_t ydb_result_details_code(const YdbResultDetails *d) {
+  return d ? d->code : YDB_OK;
+}
+
 const char *get_message(const YdbResultDetails *d) {
   if (!d) {
     return nullptr;
   }
+  if (!d->message_ready) {
+    try {
+      d->message = d->status ? d->status->GetIssues().ToString() : d->text;
+      for (size_t i = 0; i < d->trail_size; ++i) {
+        if (!d->message.empty()) {
+          d->message += ' ';
+        }
+        d->message += "from ";
+        d->message += d->trail[i];
+      }
+    } catch (...) {
+      d->message = d->text;
+    }
+    d->message_ready = true;
+  }
   return d->message.c_str();
 }
 
 int ydb_is_status_retriable(ydb_status_t sdk_status_code) {
   using NYdb::EStatus;
+  // binding codes are negative and never collide with EStatus values
+  if (sdk_status_code == YDB_ERR_CONNECTION) {
+    return 1;
+  }
   EStatus s = static_cast<EStatus>(sdk_status_code);
   switch (s) {
   case EStatus::ABORTED:
@@ -68,18 +126,17 @@ ydb_status_t ydb_result_details_fail(YdbResultDetails *d, ydb_status_t code,
                                      const char *msg) {
   if (d) {
     d->code = code;
-    ydb_result_details_set_message(d, msg ? msg : "");
-  }
-
-  if (msg) {
-    ydb_result_details_print(msg);
+    d->sdk_status = 0;
+    clear_failure(d);
+    set_text(d, msg);
   }
 
+  ydb_log(YDB_LOG_ERROR, code, msg);
   return code;
 }
 
 void ydb_result_details_print(const char *err_msg) {
-  std::cout << "[ydb-c]: " << err_msg << std::endl;
+  ydb_log(YDB_LOG_INFO, YDB_OK, err_msg);
 }
 
 } // extern "C"
@@ -98,18 +155,24 @@ bool isFatal(YdbResultDetails *rd) {
 ydb_status_t ydb_fill_from_status(YdbResultDetails *details,
                                   const NYdb::TStatus &st) {
   const ydb_status_t code = status_to_ydb_code(st.GetStatus());
-  const std::string msg = st.GetIssues().ToString();
-
+  ydb_metrics_count_status(code);
   if (details) {
-    ydb_result_details_set_status(details, code);
-    ydb_result_details_set_message(details, msg);
-    return code;
+    details->code = code;
+    details->sdk_status = static_cast<int32_t>(st.GetStatus());
+    clear_failure(details);
+    if (!details->codes_only && !st.IsSuccess()) {
+      details->status.emplace(st);
+    }
+  }
+
+  if (!st.IsSuccess()) {
+    const int retriable =
+        ydb_is_status_retriable(static_cast<ydb_status_t>(st.GetStatus()));
+    const ydb_log_level_t level = retriable ? YDB_LOG_WARN : YDB_LOG_ERROR;
+    if (ydb_log_enabled(level)) {
+      ydb_log(level, code, st.GetIssues().ToString().c_str());
+    }
   }
-
-  if (!msg.empty()) {
-    ydb_result_details_print(msg.c_str());
-  }
-
   return code;
 }
 
@@ -126,8 +189,11 @@ ydb_status_t ydb_rd_fail(YdbResultDetails *rd, ydb_status_t code,
 }
 
 void ydb_append_fatal_context(YdbResultDetails *rd, const char *func) {
-  std::string error_msg = std::string("from ") + func;
-  ydb_result_details_append_message(rd, error_msg.c_str());
+  if (rd->codes_only || rd->trail_size == YdbResultDetails::kMaxTrail) {
+    return;
+  }
+  rd->trail[rd->trail_size++] = func;
+  invalidate_message(rd);
 }
 
 std::optional<ydb_status_t> ydb_check_rd_status(YdbResultDetails *rd,
@@ -150,22 +216,6 @@ bool ydb_check_rd_fatal(YdbResultDetails *rd, const char *func) {
   return false;
 }
 
-void ydb_result_details_set_message(YdbResultDetails *d,
-                                    const std::string &msg) {
-  if (!d) {
-    return;
-  }
-  d->message = msg;
-}
-
-void ydb_result_details_append_message(YdbResultDetails *d,
-                                       const std::string &msg) {
-  if (!d) {
-    return;
-  }
-  d->message += msg;
-}
-
 void ydb_result_details_set_context(YdbResultDetails *d,
                                     const std::string &ctx) {
   if (!d) {
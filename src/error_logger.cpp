@@ -0,0 +1,215 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<std::shared_ptr<YdbLoggerState>> installed_logger;
+
+int64_t steady_seconds() {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// fixed window per second; a reset racing with other writers may let a few
+// extra records through, which is fine for a log limiter
+bool within_rate_limit(YdbLoggerState *logger) {
+  const uint32_t limit =
+      logger->max_per_second.load(std::memory_order_relaxed);
+  if (limit == 0) {
+    return true;
+  }
+  const int64_t now = steady_seconds();
+  int64_t window = logger->window.load(std::memory_order_relaxed);
+  if (window != now &&
+      logger->window.compare_exchange_strong(window, now,
+                                             std::memory_order_relaxed)) {
+    logger->window_count.store(0, std::memory_order_relaxed);
+  }
+  return logger->window_count.fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+void push_record(YdbLoggerState *logger, ydb_log_level_t level,
+                 ydb_status_t code, const char *message) {
+  std::unique_lock lock(logger->ring_mutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    logger->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const size_t capacity = logger->ring.size();
+  if (capacity == 0) {
+    return;
+  }
+  auto &slot = logger->ring[(logger->ring_head + logger->ring_size) % capacity];
+  slot.level = level;
+  slot.code = code;
+  std::strncpy(slot.message, message, YdbLoggerState::kMessageSize - 1);
+  slot.message[YdbLoggerState::kMessageSize - 1] = '\0';
+  if (logger->ring_size < capacity) {
+    ++logger->ring_size;
+  } else {
+    logger->ring_head = (logger->ring_head + 1) % capacity;
+    logger->dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+} // namespace
+
+bool ydb_log_enabled(ydb_log_level_t level) {
+  const auto logger = installed_logger.load(std::memory_order_acquire);
+  return logger && level >= logger->level;
+}
+
+void ydb_log(ydb_log_level_t level, ydb_status_t code, const char *message) {
+  // the local reference keeps the logger alive through a concurrent free
+  const auto logger = installed_logger.load(std::memory_order_acquire);
+  if (!logger || level < logger->level) {
+    return;
+  }
+  if (!within_rate_limit(logger.get())) {
+    logger->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const char *text = message ? message : "";
+  push_record(logger.get(), level, code, text);
+  const auto sink = logger->sink.load(std::memory_order_acquire);
+  if (sink) {
+    sink->callback(level, code, text, sink->user_data);
+  }
+}
+
+extern "C" {
+
+YdbErrorLogger *ydb_error_logger_create(ydb_log_level_t level,
+                                        YdbResultDetails *rd) {
+  auto *logger = new (std::nothrow) YdbErrorLogger();
+  if (!logger) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "failed to allocate logger");
+    return nullptr;
+  }
+  try {
+    std::atomic<bool> *released = &logger->released;
+    logger->state.reset(new YdbLoggerState(), [released](YdbLoggerState *s) {
+      delete s;
+      released->store(true, std::memory_order_release);
+    });
+    logger->state->level = level;
+    return logger;
+  } catch (const std::exception &e) {
+    delete logger;
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  }
+}
+
+ydb_status_t ydb_error_logger_set_callback(YdbErrorLogger *logger,
+                                           ydb_log_callback_t cb,
+                                           void *user_data,
+                                           YdbResultDetails *rd) {
+  if (!logger) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "logger is null");
+  }
+  try {
+    std::shared_ptr<const YdbLoggerState::Sink> sink;
+    if (cb) {
+      sink = std::make_shared<const YdbLoggerState::Sink>(
+          YdbLoggerState::Sink{cb, user_data});
+    }
+    logger->state->sink.store(std::move(sink), std::memory_order_release);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+ydb_status_t ydb_error_logger_set_ring_buffer(YdbErrorLogger *logger,
+                                              uint32_t capacity,
+                                              YdbResultDetails *rd) {
+  if (!logger) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "logger is null");
+  }
+  try {
+    auto &state = *logger->state;
+    std::lock_guard lock(state.ring_mutex);
+    state.ring.assign(capacity, YdbLoggerState::Record{});
+    state.ring_head = 0;
+    state.ring_size = 0;
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+ydb_status_t ydb_error_logger_set_rate_limit(YdbErrorLogger *logger,
+                                             uint32_t max_per_second,
+                                             YdbResultDetails *rd) {
+  if (!logger) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "logger is null");
+  }
+  logger->state->max_per_second.store(max_per_second,
+                                      std::memory_order_relaxed);
+  return YDB_OK;
+}
+
+size_t ydb_error_logger_drain(YdbErrorLogger *logger, ydb_log_callback_t cb,
+                              void *user_data) {
+  if (!logger || !cb) {
+    return 0;
+  }
+  auto &state = *logger->state;
+  std::vector<YdbLoggerState::Record> records;
+  {
+    std::lock_guard lock(state.ring_mutex);
+    const size_t capacity = state.ring.size();
+    records.reserve(state.ring_size);
+    for (size_t i = 0; i < state.ring_size; ++i) {
+      records.push_back(state.ring[(state.ring_head + i) % capacity]);
+    }
+    state.ring_head = 0;
+    state.ring_size = 0;
+  }
+  // outside the lock, so cb may log without deadlocking
+  for (const auto &record : records) {
+    cb(record.level, record.code, record.message, user_data);
+  }
+  return records.size();
+}
+
+uint64_t ydb_error_logger_dropped(const YdbErrorLogger *logger) {
+  return logger ? logger->state->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+void ydb_error_logger_install(YdbErrorLogger *logger) {
+  installed_logger.store(logger ? logger->state : nullptr,
+                         std::memory_order_release);
+}
+
+void ydb_error_logger_free(YdbErrorLogger *logger) {
+  if (!logger) {
+    return;
+  }
+  std::shared_ptr<YdbLoggerState> expected = logger->state;
+  installed_logger.compare_exchange_strong(expected, nullptr,
+                                           std::memory_order_acq_rel);
+  expected.reset();
+  // once uninstalled no new log call can pick the state up; wait out the
+  // ones already running so the callback's user_data may be freed after us
+  logger->state.reset();
+  while (!logger->released.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+  delete logger;
+}
+
+} // extern "C"
@@ -3,80 +3,498 @@
 #include "ydb.h"
 #include "ydb_error.h"
 
+#include <ydb-cpp-sdk/client/discovery/discovery.h>
 #include <ydb-cpp-sdk/client/driver/driver.h>
 #include <ydb-cpp-sdk/client/params/params.h>
 #include <ydb-cpp-sdk/client/query/client.h>
 #include <ydb-cpp-sdk/client/result/result.h>
 #include <ydb-cpp-sdk/client/table/table.h>
+#include <ydb-cpp-sdk/client/topic/client.h>
+#include <ydb-cpp-sdk/client/value/value.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <initializer_list>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+/* ── Arena ───────────────────────────────────────────────────────── */
+
+struct YdbArena {
+  struct Cleanup {
+    void *object;
+    size_t size;
+    void (*destroy)(void *);
+  };
+
+  size_t initial_size;
+  std::unique_ptr<std::byte[]> initial; // reused after every reset
+  std::pmr::monotonic_buffer_resource resource;
+  std::vector<Cleanup> cleanups; // heap backed, keeps capacity across resets
+
+  explicit YdbArena(size_t initial_size)
+      : initial_size(initial_size), initial(new std::byte[initial_size]),
+        resource(initial.get(), initial_size) {}
+};
+
+// arena bound to the calling thread by ydb_arena_bind, nullptr if none
+YdbArena *ydb_current_arena();
+
+// wrappers carrying an `arena` member come from the bound arena when there
+// is one, otherwise from the heap
+template <typename T, typename... Args> T *ydb_arena_new(Args &&...args) {
+  YdbArena *arena = ydb_current_arena();
+  if (!arena) {
+    return new T(std::forward<Args>(args)...);
+  }
+  void *memory = arena->resource.allocate(sizeof(T), alignof(T));
+  T *object = new (memory) T(std::forward<Args>(args)...);
+  object->arena = arena;
+  arena->cleanups.push_back(
+      {object, sizeof(T), [](void *p) { static_cast<T *>(p)->~T(); }});
+  return object;
+}
+
+// arena objects are destroyed by ydb_arena_reset, never one by one
+template <typename T> void ydb_arena_delete(T *object) {
+  if (object && !object->arena) {
+    delete object;
+  }
+}
+
+struct YdbArenaDeleter {
+  template <typename T> void operator()(T *object) const {
+    ydb_arena_delete(object);
+  }
+};
+
+template <typename T> using YdbArenaPtr = std::unique_ptr<T, YdbArenaDeleter>;
+
+/* ── Tracing ─────────────────────────────────────────────────────── */
+
+struct YdbTracer {
+  ydb_span_start_callback_t start = nullptr;
+  ydb_span_end_callback_t end = nullptr;
+  void *user_data = nullptr;
+};
+
+// one client span; ends on destruction with YDB_ERR_INTERNAL unless end()
+// ran first, which is only the case when an exception unwinds the scope
+struct YdbSpan {
+  std::shared_ptr<const YdbTracer> tracer;
+  void *handle = nullptr;
+  std::chrono::steady_clock::time_point start;
+
+  YdbSpan(std::shared_ptr<const YdbTracer> t, const char *name,
+          std::initializer_list<YdbSpanAttribute> attrs = {});
+  YdbSpan(const YdbSpan &) = delete;
+  YdbSpan &operator=(const YdbSpan &) = delete;
+  ~YdbSpan() { end(YDB_ERR_INTERNAL); }
+
+  // returns status so call sites can write `return span.end(code);`
+  ydb_status_t end(ydb_status_t status);
+};
+
+// the ydb.ExecuteQuery span; db.query.text is attached only when the driver
+// opted in with ydb_driver_set_trace_query_text, cut to that many bytes
+YdbSpan ydb_query_span(const YdbDriver *drv, std::string_view yql);
+
+// W3C traceparent set by ydb_trace_set_parent on this thread, may be empty
+const std::string &ydb_trace_parent();
+
 struct YdbDriverConfig {
   std::string endpoint;
   std::string database;
   std::string auth_token;
+  uint32_t session_pool_min = 0; // 0 keeps the SDK default
+  uint32_t session_pool_max = 0;
+  uint32_t session_idle_timeout_ms = 0;
+
+  // 0 / unset keeps the SDK default for everything below
+  uint32_t network_threads = 0;
+  uint32_t client_threads = 0;
+  uint32_t max_client_queue_size = 0;
+  uint32_t grpc_keepalive_timeout_ms = 0;
+  bool grpc_keepalive_permit_without_calls = false;
+  uint64_t max_inbound_message_size = 0;
+  uint64_t max_outbound_message_size = 0;
+  std::optional<NYdb::EDiscoveryMode> discovery_mode;
+  ydb_balancing_policy_t balancing_policy = YDB_BALANCING_DEFAULT;
+  std::string balancing_location; // empty means the client's own DC
+  uint32_t warm_sessions = 1;
+};
+
+struct YdbEndpointList {
+  std::vector<NYdb::NDiscovery::TEndpointInfo> endpoints;
+  std::vector<YdbEndpointInfo> items; // points into endpoints
+};
+
+// filled from SDK threads by the sessions ydb_driver_start requests
+struct YdbDriverReadiness {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool started = false;
+  bool ready = false;    // some session was created, sticky
+  uint32_t pending = 0;  // session requests in flight
+  std::optional<NYdb::TStatus> last_error;
+  std::vector<NYdb::NQuery::TSession> warm; // back to the pool when done
 };
 
 struct YdbDriver {
   std::unique_ptr<NYdb::TDriverConfig> config;
   std::unique_ptr<NYdb::TDriver> driver;
+  NYdb::NQuery::TClientSettings query_client_settings;
+  // every YdbQueryClient is a copy of this one and shares its session pool
+  std::unique_ptr<NYdb::NQuery::TQueryClient> query_client;
+  uint32_t warm_sessions = 1;
+  std::shared_ptr<YdbDriverReadiness> readiness =
+      std::make_shared<YdbDriverReadiness>();
+  std::atomic<std::shared_ptr<const YdbTracer>> tracer;
+  std::atomic<uint32_t> trace_query_text_bytes{0}; // 0 leaves the text out
 };
 
+std::shared_ptr<const YdbTracer> ydb_driver_tracer(const YdbDriver *drv);
+
 struct YdbQueryParams {
-  NYdb::TParamsBuilder builder;
+  // a reset keeps every declared name, only the values are dropped
+  std::map<std::string, std::optional<NYdb::TValue>, std::less<>> values;
+  // built lazily by the first execute after a write and reused until the
+  // next one; TParams is immutable in the SDK, so a single set still costs
+  // a fresh TValue and a full rebuild that copies every bound value
+  mutable std::optional<NYdb::TParams> built;
 };
 
 struct YdbParamBuilder {
+  YdbArena *arena = nullptr;
   YdbQueryParams *owner;
-  NYdb::TParamValueBuilder *slot;
+  std::string name;
+  NYdb::TValueBuilder value;
 };
 
+void ydb_query_params_store(YdbQueryParams *p, std::string_view name,
+                            NYdb::TValue value);
+const NYdb::TParams &ydb_query_params_get(const YdbQueryParams *p);
+// borrows the stored value; nullptr if the name is unknown or unset
+const NYdb::TValue *ydb_query_params_find(const YdbQueryParams *p,
+                                          std::string_view name);
+
 /* ── Results ─────────────────────────────────────────────────────── */
 
 struct YdbResultSet {
+  YdbArena *arena = nullptr;
   NYdb::TResultSet resultSet;
   NYdb::TResultSetParser parser;
-  std::string scratch;
+  // the parser is already on a row that ydb_resultset_fetch_columns could
+  // not fit; the next read consumes it before advancing
+  bool row_pending = false;
+  size_t rows_read = 0; // rows the parser has moved onto so far
+  std::vector<YdbColumnInfo> schema; // names point into resultSet's metadata
+  // iteration span, opened by the first row read and closed at the end
+  std::shared_ptr<const YdbTracer> tracer;
+  std::optional<YdbSpan> iteration;
 
-  explicit YdbResultSet(NYdb::TResultSet rs)
-      : resultSet(std::move(rs)), parser(resultSet) {}
+  explicit YdbResultSet(NYdb::TResultSet rs);
+  // the one way rows are consumed, by next_row, fetch_columns and the Arrow
+  // export alike: takes a pending row first and keeps the span in step
+  bool advance();
+  ~YdbResultSet() {
+    if (iteration) {
+      // stopping before the last row is not an error
+      iteration->end(YDB_OK);
+    }
+  }
 };
 
 struct YdbResultSets {
-  std::vector<std::unique_ptr<YdbResultSet>> sets;
+  YdbArena *arena = nullptr;
+  std::pmr::vector<YdbArenaPtr<YdbResultSet>> sets;
+
+  YdbResultSets()
+      : sets(ydb_current_arena() ? &ydb_current_arena()->resource
+                                 : std::pmr::get_default_resource()) {}
+};
+
+// wraps every set of a response, from the bound arena when there is one
+YdbArenaPtr<YdbResultSets>
+ydb_collect_result_sets(const std::vector<NYdb::TResultSet> &sets,
+                        const std::shared_ptr<const YdbTracer> &tracer);
+
+/* ── Table Service ───────────────────────────────────────────────── */
+
+struct YdbTableClient {
+  std::unique_ptr<NYdb::NTable::TTableClient> client;
+  YdbDriver *parent_driver;
+};
+
+/* ── Topic Service ───────────────────────────────────────────────── */
+
+struct YdbTopicClient {
+  std::unique_ptr<NYdb::NTopic::TTopicClient> client;
+  YdbDriver *parent_driver;
+};
+
+struct YdbTopicWriterConfig {
+  NYdb::NTopic::TWriteSessionSettings settings;
+  ydb_topic_ack_callback_t on_ack = nullptr;
+  void *user_data = nullptr;
+};
+
+// shared with the SDK event handlers, which may outlive the writer
+struct YdbTopicWriterState {
+  std::mutex mutex;
+  std::condition_variable ready; // a token arrived or the session closed
+  std::deque<NYdb::NTopic::TContinuationToken> tokens;
+  std::optional<NYdb::TStatus> closed;
+  ydb_topic_ack_callback_t on_ack = nullptr;
+  void *user_data = nullptr;
+};
+
+struct YdbTopicWriter {
+  std::shared_ptr<YdbTopicWriterState> state;
+  std::shared_ptr<NYdb::NTopic::IWriteSession> session;
+};
+
+struct YdbTopicReaderConfig {
+  NYdb::NTopic::TReadSessionSettings settings;
+};
+
+struct YdbTopicReader {
+  std::shared_ptr<NYdb::NTopic::IReadSession> session;
+};
+
+struct YdbTopicBatch {
+  std::vector<NYdb::NTopic::TReadSessionEvent::TDataReceivedEvent> events;
+  std::vector<YdbTopicMessage> messages; // point into events
 };
 
 /* ── Query Service ───────────────────────────────────────────────── */
 
+struct YdbPreparedQuery {
+  std::string text;
+  YdbQueryClient *parent_client;
+};
+
+struct YdbExecSettings {
+  uint32_t client_timeout_ms = 0;
+  std::optional<std::string> resource_pool;
+  std::optional<NYdb::NQuery::EStatsMode> stats_mode;
+};
+
 struct YdbQueryClient {
   std::unique_ptr<NYdb::NQuery::TQueryClient> client;
   YdbDriver *parent_driver;
+  // inherited by transactions begun afterwards; swapped whole so calls
+  // already running keep the settings they started with
+  std::atomic<std::shared_ptr<const YdbExecSettings>> exec;
+
+  // keys view into the owned YdbPreparedQuery::text; entries only go away
+  // through ydb_query_unprepare, so lookups take the shared lock
+  std::shared_mutex prepared_mutex;
+  std::unordered_map<std::string_view, std::unique_ptr<YdbPreparedQuery>>
+      prepared;
+  std::atomic<size_t> prepared_limit{1024};
+};
+
+struct YdbSession {
+  NYdb::NQuery::TSession session;
+  YdbQueryClient *parent_client;
+  YdbSession(NYdb::NQuery::TSession s, YdbQueryClient *qc)
+      : session(std::move(s)), parent_client(qc) {}
 };
 
 struct YdbQueryTransaction {
-  NYdb::NQuery::TTransaction tx;
+  // empty until the first execute of a lazily begun transaction
+  std::optional<NYdb::NQuery::TTransaction> tx;
   NYdb::NQuery::TSession session;
+  NYdb::NQuery::TTxSettings settings;
+  std::shared_ptr<const YdbExecSettings> exec;
+  YdbDriver *parent_driver = nullptr;
+  const YdbQueryClient *parent_client = nullptr; // owner of usable handles
+  bool committed = false;
+  bool rolled_back = false;
   YdbQueryTransaction(NYdb::NQuery::TSession s, NYdb::NQuery::TTransaction t)
       : tx(std::move(t)), session(std::move(s)) {}
+  YdbQueryTransaction(NYdb::NQuery::TSession s, NYdb::NQuery::TTxSettings st)
+      : session(std::move(s)), settings(std::move(st)) {}
+};
+
+struct YdbResultStream {
+  NYdb::NQuery::TExecuteQueryIterator it;
+  bool finished = false;
+  std::shared_ptr<const YdbTracer> tracer; // handed to every part
+  explicit YdbResultStream(NYdb::NQuery::TExecuteQueryIterator i)
+      : it(std::move(i)) {}
+};
+
+// outlives the future when SDK callbacks are still pending; recursive so a
+// ready callback may free its own future
+struct YdbQueryFutureState {
+  std::recursive_mutex mutex;
+  bool cancelled = false;
 };
 
+struct YdbQueryFuture {
+  NYdb::NQuery::TAsyncExecuteQueryResult future;
+  std::shared_ptr<YdbQueryFutureState> state =
+      std::make_shared<YdbQueryFutureState>();
+  YdbDriver *parent_driver = nullptr;
+  bool consumed = false;
+  explicit YdbQueryFuture(NYdb::NQuery::TAsyncExecuteQueryResult f)
+      : future(std::move(f)) {}
+};
+
+struct YdbRetryBackoff {
+  uint32_t slot_ms = 0;
+  uint32_t ceiling = 0; // delay is slot_ms * 2^min(attempt, ceiling)
+};
+
+// the backoff handed to the SDK retry loop, which has no cap of its own:
+// slot and ceiling shrink so slot_ms * 2^ceiling stays within
+// max_backoff_ms; 0 leaves the backoff as it is
+YdbRetryBackoff ydb_retry_backoff_capped(const YdbRetryBackoff &backoff,
+                                         uint32_t max_backoff_ms);
+
 struct YdbQueryRetrySettings {
   uint32_t max_retries;
   uint32_t current_retries;
   uint32_t timeout_ms;
+  YdbRetryBackoff fast; // ABORTED, SESSION_BUSY, UNAVAILABLE, ...
+  YdbRetryBackoff slow; // OVERLOADED, CLIENT_RESOURCE_EXHAUSTED
+  uint32_t max_backoff_ms = 0; // 0 means uncapped
+  double jitter = 0.0;         // randomized share of every delay, [0, 1]
+  uint32_t deadline_ms = 0;    // budget across all attempts, 0 means none
+  bool idempotent = false;
+  std::chrono::steady_clock::time_point started;
+};
+
+/* ── Metrics ─────────────────────────────────────────────────────── */
+
+// log-linear latency buckets in microseconds: exact below 4 us, then four
+// sub-buckets per power of two up to 2^36 us
+struct YdbMetricsLayout {
+  static constexpr uint32_t kSubBits = 2;
+  static constexpr uint32_t kSub = 1u << kSubBits;
+  static constexpr size_t kBuckets = 36 * kSub;
+  static constexpr size_t kStatusCodes = 16; // indexed by -ydb_status_t
+};
+
+size_t ydb_metrics_bucket(uint64_t us);
+uint64_t ydb_metrics_bucket_upper(size_t bucket);
+
+struct YdbMetricsSnapshot {
+  using Buckets = std::array<uint64_t, YdbMetricsLayout::kBuckets>;
+  std::array<Buckets, YDB_METRIC_OP_COUNT> buckets{};
+  std::array<uint64_t, YDB_METRIC_OP_COUNT> sum_us{};
+  std::array<uint64_t, YDB_METRIC_OP_COUNT> max_us{};
+  std::array<uint64_t, YDB_METRIC_COUNTER_COUNT> counters{};
+  std::array<uint64_t, YdbMetricsLayout::kStatusCodes> statuses{};
+  std::string text;
+};
+
+bool ydb_metrics_enabled();
+bool ydb_metrics_bytes_enabled(); // opt-in, sizing a result walks all of it
+void ydb_metrics_record(ydb_metric_op_t op,
+                        std::chrono::steady_clock::duration elapsed);
+void ydb_metrics_add(ydb_metric_counter_t counter, uint64_t n);
+void ydb_metrics_count_status(ydb_status_t code);
+
+// records one `op` sample at end() or scope exit, whichever comes first;
+// execute paths end it when the RPC returns, so wrapping and counting the
+// result sets is not billed to the server
+struct YdbMetricsTimer {
+  ydb_metric_op_t op;
+  bool enabled = ydb_metrics_enabled();
+  std::chrono::steady_clock::time_point start =
+      enabled ? std::chrono::steady_clock::now()
+              : std::chrono::steady_clock::time_point{};
+
+  explicit YdbMetricsTimer(ydb_metric_op_t o) : op(o) {}
+  YdbMetricsTimer(const YdbMetricsTimer &) = delete;
+  YdbMetricsTimer &operator=(const YdbMetricsTimer &) = delete;
+  ~YdbMetricsTimer() { end(); }
+
+  void end() {
+    if (enabled) {
+      enabled = false;
+      ydb_metrics_record(op, std::chrono::steady_clock::now() - start);
+    }
+  }
 };
 
 /* ── Error Handling ──────────────────────────────────────────────── */
 
+// Failures record only the code, a truncated copy of the binding's text or
+// the SDK status, and the __func__ names of calls refused afterwards; the
+// readable message is assembled by get_message on first use.
 struct YdbResultDetails {
-  ydb_status_t code;
-  std::string message;
+  static constexpr size_t kTextSize = 128;
+  static constexpr size_t kMaxTrail = 8;
+
+  ydb_status_t code = YDB_OK;
+  int32_t sdk_status = 0; // raw NYdb::EStatus of the last SDK call, 0 if none
+  bool codes_only = false; // keep nothing but code and sdk_status
+  bool thread_owned = false; // from ydb_result_details_thread_local
+  char text[kTextSize] = {};
+  std::optional<NYdb::TStatus> status; // issues are formatted on demand
+  const char *trail[kMaxTrail] = {};   // static strings only
+  size_t trail_size = 0;
   std::string context;
+
+  mutable std::string message;
+  mutable bool message_ready = false;
+};
+
+// shared between the handle and the installed slot, so a log call that
+// loaded it before a free keeps it alive until the call returns
+struct YdbLoggerState {
+  static constexpr size_t kMessageSize = 256;
+  struct Record {
+    ydb_log_level_t level;
+    ydb_status_t code;
+    char message[kMessageSize]; // truncated, always terminated
+  };
+  struct Sink {
+    ydb_log_callback_t callback;
+    void *user_data;
+  };
+
+  ydb_log_level_t level;
+  // swapped as a pair, so a callback never sees another callback's data
+  std::atomic<std::shared_ptr<const Sink>> sink;
+
+  // slots are allocated up front, so logging never touches the heap
+  std::mutex ring_mutex;
+  std::vector<Record> ring;
+  size_t ring_head = 0;
+  size_t ring_size = 0;
+
+  std::atomic<uint32_t> max_per_second{0};
+  std::atomic<int64_t> window{0};
+  std::atomic<uint32_t> window_count{0};
+  std::atomic<uint64_t> dropped{0};
 };
 
+struct YdbErrorLogger {
+  std::shared_ptr<YdbLoggerState> state;
+  // set by the state's deleter, on whichever thread drops it last
+  std::atomic<bool> released{false};
+};
+
+bool ydb_log_enabled(ydb_log_level_t level);
+void ydb_log(ydb_log_level_t level, ydb_status_t code, const char *message);
+
 ydb_status_t status_to_ydb_code(NYdb::EStatus s);
 ydb_status_t ydb_fill_from_status(YdbResultDetails *details,
                                   const NYdb::TStatus &st);
@@ -84,10 +502,6 @@ ydb_status_t ydb_fill_from_status(YdbResultDetails *details,
 bool isFatal(YdbResultDetails *rd);
 
 void ydb_result_details_set_status(YdbResultDetails *rd, ydb_status_t code);
-void ydb_result_details_set_message(YdbResultDetails *rd,
-                                    const std::string &msg);
-void ydb_result_details_append_message(YdbResultDetails *rd,
-                                       const std::string &msg);
 void ydb_result_details_set_context(YdbResultDetails *rd,
                                     const std::string &ctx);
 
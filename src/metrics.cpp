@@ -0,0 +1,339 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <new>
+#include <string>
+
+namespace {
+
+using Layout = YdbMetricsLayout;
+
+constexpr size_t kShards = 16;
+
+// one shard per group of threads so hot counters do not share cache lines
+struct alignas(64) Shard {
+  std::array<std::array<std::atomic<uint64_t>, Layout::kBuckets>,
+             YDB_METRIC_OP_COUNT>
+      buckets{};
+  std::array<std::atomic<uint64_t>, YDB_METRIC_OP_COUNT> sum_us{};
+  std::array<std::atomic<uint64_t>, YDB_METRIC_OP_COUNT> max_us{};
+  std::array<std::atomic<uint64_t>, YDB_METRIC_COUNTER_COUNT> counters{};
+  std::array<std::atomic<uint64_t>, Layout::kStatusCodes> statuses{};
+};
+
+std::array<Shard, kShards> shards;
+std::atomic<bool> enabled{true};
+std::atomic<bool> bytes_enabled{false};
+std::atomic<size_t> next_shard{0};
+
+Shard &local_shard() {
+  thread_local Shard &shard =
+      shards[next_shard.fetch_add(1, std::memory_order_relaxed) % kShards];
+  return shard;
+}
+
+void add(std::atomic<uint64_t> &slot, uint64_t n) {
+  slot.fetch_add(n, std::memory_order_relaxed);
+}
+
+void store_max(std::atomic<uint64_t> &slot, uint64_t value) {
+  uint64_t current = slot.load(std::memory_order_relaxed);
+  while (current < value &&
+         !slot.compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+const char *op_name(size_t op) {
+  switch (op) {
+  case YDB_METRIC_GET_SESSION:
+    return "get_session";
+  case YDB_METRIC_EXECUTE:
+    return "execute";
+  case YDB_METRIC_COMMIT:
+    return "commit";
+  case YDB_METRIC_ROLLBACK:
+    return "rollback";
+  default:
+    return "unknown";
+  }
+}
+
+const char *counter_name(size_t counter) {
+  switch (counter) {
+  case YDB_METRIC_RETRY_ATTEMPTS:
+    return "ydb_c_retry_attempts_total";
+  case YDB_METRIC_BYTES_RETURNED:
+    return "ydb_c_result_bytes_total";
+  case YDB_METRIC_ROWS_RETURNED:
+    return "ydb_c_result_rows_total";
+  default:
+    return "ydb_c_unknown_total";
+  }
+}
+
+uint64_t percentile(const YdbMetricsSnapshot::Buckets &buckets, uint64_t count,
+                    double q) {
+  if (count == 0) {
+    return 0;
+  }
+  // nearest-rank: the ceil(q * count)-th smallest sample
+  const auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(static_cast<double>(count) * q)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return ydb_metrics_bucket_upper(i);
+    }
+  }
+  return ydb_metrics_bucket_upper(buckets.size() - 1);
+}
+
+void append(std::string &out, const char *fmt, ...) {
+  char line[160];
+  va_list args;
+  va_start(args, fmt);
+  const int n = std::vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  if (n > 0) {
+    out.append(line, std::min<size_t>(n, sizeof(line) - 1));
+  }
+}
+
+void render_prometheus(YdbMetricsSnapshot &s) {
+  std::string &out = s.text;
+  out.clear();
+
+  out += "# TYPE ydb_c_operation_duration_seconds histogram\n";
+  for (size_t op = 0; op < YDB_METRIC_OP_COUNT; ++op) {
+    // only power-of-two bounds, cumulative counts stay exact
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < Layout::kBuckets; ++i) {
+      cumulative += s.buckets[op][i];
+      if (i % Layout::kSub != Layout::kSub - 1) {
+        continue;
+      }
+      // samples are whole microseconds, so the upper bound is inclusive
+      const double le = static_cast<double>(ydb_metrics_bucket_upper(i)) / 1e6;
+      append(out,
+             "ydb_c_operation_duration_seconds_bucket{op=\"%s\",le=\"%g\"} "
+             "%" PRIu64 "\n",
+             op_name(op), le, cumulative);
+    }
+    append(out,
+           "ydb_c_operation_duration_seconds_bucket{op=\"%s\",le=\"+Inf\"} "
+           "%" PRIu64 "\n",
+           op_name(op), cumulative);
+    append(out, "ydb_c_operation_duration_seconds_sum{op=\"%s\"} %.6f\n",
+           op_name(op), static_cast<double>(s.sum_us[op]) / 1e6);
+    append(out,
+           "ydb_c_operation_duration_seconds_count{op=\"%s\"} %" PRIu64 "\n",
+           op_name(op), cumulative);
+  }
+
+  for (size_t c = 0; c < YDB_METRIC_COUNTER_COUNT; ++c) {
+    append(out, "# TYPE %s counter\n%s %" PRIu64 "\n", counter_name(c),
+           counter_name(c), s.counters[c]);
+  }
+
+  out += "# TYPE ydb_c_status_total counter\n";
+  for (size_t i = 0; i < s.statuses.size(); ++i) {
+    if (s.statuses[i] == 0) {
+      continue;
+    }
+    append(out, "ydb_c_status_total{code=\"%d\"} %" PRIu64 "\n",
+           -static_cast<int>(i), s.statuses[i]);
+  }
+}
+
+} // namespace
+
+size_t ydb_metrics_bucket(uint64_t us) {
+  if (us < Layout::kSub) {
+    return static_cast<size_t>(us);
+  }
+  const uint32_t octave = std::bit_width(us) - 1;
+  const uint32_t shift = octave - Layout::kSubBits;
+  const size_t sub = (us >> shift) & (Layout::kSub - 1);
+  const size_t bucket = (shift + 1) * Layout::kSub + sub;
+  return std::min(bucket, Layout::kBuckets - 1);
+}
+
+uint64_t ydb_metrics_bucket_upper(size_t bucket) {
+  if (bucket < Layout::kSub) {
+    return bucket;
+  }
+  const uint32_t shift = static_cast<uint32_t>(bucket / Layout::kSub) - 1;
+  const uint64_t lower = (Layout::kSub + bucket % Layout::kSub) << shift;
+  return lower + (uint64_t{1} << shift) - 1;
+}
+
+bool ydb_metrics_enabled() { return enabled.load(std::memory_order_relaxed); }
+
+bool ydb_metrics_bytes_enabled() {
+  return bytes_enabled.load(std::memory_order_relaxed);
+}
+
+void ydb_metrics_record(ydb_metric_op_t op,
+                        std::chrono::steady_clock::duration elapsed) {
+  if (op < 0 || op >= YDB_METRIC_OP_COUNT) {
+    return;
+  }
+  const auto us = static_cast<uint64_t>(std::max<int64_t>(
+      0, std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+             .count()));
+  Shard &shard = local_shard();
+  add(shard.buckets[op][ydb_metrics_bucket(us)], 1);
+  add(shard.sum_us[op], us);
+  store_max(shard.max_us[op], us);
+}
+
+void ydb_metrics_add(ydb_metric_counter_t counter, uint64_t n) {
+  if (!ydb_metrics_enabled() || counter < 0 ||
+      counter >= YDB_METRIC_COUNTER_COUNT) {
+    return;
+  }
+  add(local_shard().counters[counter], n);
+}
+
+void ydb_metrics_count_status(ydb_status_t code) {
+  if (!ydb_metrics_enabled()) {
+    return;
+  }
+  const size_t index = std::min<size_t>(code > 0 ? 0 : -code,
+                                        Layout::kStatusCodes - 1);
+  add(local_shard().statuses[index], 1);
+}
+
+extern "C" {
+
+void ydb_metrics_set_enabled(int on) {
+  enabled.store(on != 0, std::memory_order_relaxed);
+}
+
+void ydb_metrics_set_count_bytes(int on) {
+  bytes_enabled.store(on != 0, std::memory_order_relaxed);
+}
+
+void ydb_metrics_reset(void) {
+  for (auto &shard : shards) {
+    for (auto &op : shard.buckets) {
+      for (auto &bucket : op) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto &slot : shard.sum_us) {
+      slot.store(0, std::memory_order_relaxed);
+    }
+    for (auto &slot : shard.max_us) {
+      slot.store(0, std::memory_order_relaxed);
+    }
+    for (auto &slot : shard.counters) {
+      slot.store(0, std::memory_order_relaxed);
+    }
+    for (auto &slot : shard.statuses) {
+      slot.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+YdbMetricsSnapshot *ydb_metrics_snapshot(YdbResultDetails *rd) {
+  auto *s = new (std::nothrow) YdbMetricsSnapshot();
+  if (!s) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                            "failed to allocate metrics snapshot");
+    return nullptr;
+  }
+  for (const auto &shard : shards) {
+    for (size_t op = 0; op < YDB_METRIC_OP_COUNT; ++op) {
+      for (size_t i = 0; i < Layout::kBuckets; ++i) {
+        s->buckets[op][i] +=
+            shard.buckets[op][i].load(std::memory_order_relaxed);
+      }
+      s->sum_us[op] += shard.sum_us[op].load(std::memory_order_relaxed);
+      s->max_us[op] = std::max(
+          s->max_us[op], shard.max_us[op].load(std::memory_order_relaxed));
+    }
+    for (size_t c = 0; c < YDB_METRIC_COUNTER_COUNT; ++c) {
+      s->counters[c] += shard.counters[c].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < Layout::kStatusCodes; ++i) {
+      s->statuses[i] += shard.statuses[i].load(std::memory_order_relaxed);
+    }
+  }
+  return s;
+}
+
+ydb_status_t ydb_metrics_snapshot_latency(const YdbMetricsSnapshot *s,
+                                          ydb_metric_op_t op,
+                                          YdbLatencySummary *out,
+                                          YdbResultDetails *rd) {
+  if (!s || !out || op < 0 || op >= YDB_METRIC_OP_COUNT) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "invalid metrics snapshot arguments");
+  }
+  const auto &buckets = s->buckets[op];
+  uint64_t count = 0;
+  for (const uint64_t n : buckets) {
+    count += n;
+  }
+  out->count = count;
+  out->sum_us = s->sum_us[op];
+  out->p50_us = percentile(buckets, count, 0.50);
+  out->p90_us = percentile(buckets, count, 0.90);
+  out->p99_us = percentile(buckets, count, 0.99);
+  out->max_us = s->max_us[op];
+  return YDB_OK;
+}
+
+uint64_t ydb_metrics_snapshot_counter(const YdbMetricsSnapshot *s,
+                                      ydb_metric_counter_t counter) {
+  if (!s || counter < 0 || counter >= YDB_METRIC_COUNTER_COUNT) {
+    return 0;
+  }
+  return s->counters[counter];
+}
+
+uint64_t ydb_metrics_snapshot_status_count(const YdbMetricsSnapshot *s,
+                                           ydb_status_t code) {
+  if (!s || code > 0 || -code >= static_cast<int>(Layout::kStatusCodes)) {
+    return 0;
+  }
+  return s->statuses[-code];
+}
+
+const char *ydb_metrics_snapshot_prometheus(YdbMetricsSnapshot *s,
+                                            YdbResultDetails *rd) {
+  try {
+    if (!s) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "metrics snapshot is null");
+      return nullptr;
+    }
+    if (s->text.empty()) {
+      render_prometheus(*s);
+    }
+    return s->text.c_str();
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+void ydb_metrics_snapshot_free(YdbMetricsSnapshot *s) { delete s; }
+
+} // extern "C"
@@ -2,24 +2,452 @@
 #include "ydb.h"
 #include "ydb_error.h"
 
+#include <algorithm>
 #include <cstdint>
-#include <unistd.h>
 #include <ydb-cpp-sdk/client/driver/driver.h>
 #include <ydb-cpp-sdk/client/params/params.h>
+#include <ydb-cpp-sdk/client/proto/accessor.h>
 #include <ydb-cpp-sdk/client/query/client.h>
 #include <ydb-cpp-sdk/client/query/query.h>
 #include <ydb-cpp-sdk/client/query/tx.h>
+#include <ydb-cpp-sdk/client/query/stats.h>
+#include <ydb-cpp-sdk/client/retry/retry.h>
+#include <src/api/protos/ydb_query_stats.pb.h>
+#include <src/api/protos/ydb_value.pb.h>
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <random>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
+
+namespace {
+
+const NYdb::TParams *build_params(const YdbQueryParams *params) {
+  return params ? &ydb_query_params_get(params) : nullptr;
+}
+
+template <typename TSettings>
+TSettings request_settings(const YdbExecSettings *exec) {
+  TSettings settings;
+  if (exec && exec->client_timeout_ms > 0) {
+    settings.ClientTimeout(TDuration::MilliSeconds(exec->client_timeout_ms));
+  }
+  if (const std::string &parent = ydb_trace_parent(); !parent.empty()) {
+    settings.Header({{"traceparent", parent}});
+  }
+  return settings;
+}
+
+NYdb::NQuery::TExecuteQuerySettings
+execute_settings(const YdbExecSettings *exec) {
+  auto settings = request_settings<NYdb::NQuery::TExecuteQuerySettings>(exec);
+  if (!exec) {
+    return settings;
+  }
+  if (exec->resource_pool) {
+    settings.ResourcePool(*exec->resource_pool);
+  }
+  if (exec->stats_mode) {
+    settings.StatsMode(*exec->stats_mode);
+  }
+  return settings;
+}
+
+// a snapshot: set_exec_settings may swap the client's settings meanwhile
+std::shared_ptr<const YdbExecSettings> client_exec(const YdbQueryClient *qc) {
+  return qc->exec.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const YdbExecSettings>
+copy_exec_settings(const YdbExecSettings *s) {
+  return s ? std::make_shared<const YdbExecSettings>(*s) : nullptr;
+}
+
+struct LastStats {
+  bool valid = false;
+  YdbQueryStats view{};
+  std::string plan;
+  std::string ast;
+};
+
+thread_local LastStats last_stats;
+
+// every finished query overwrites the slot, so stats are never attributed
+// to a later query that ran without a stats mode
+void record_stats(const std::optional<NYdb::NQuery::TExecStats> &stats) {
+  auto &last = last_stats;
+  last.valid = stats.has_value();
+  if (!stats) {
+    return;
+  }
+
+  auto &view = last.view;
+  view = YdbQueryStats{};
+  view.total_duration_us = stats->GetTotalDuration().MicroSeconds();
+  view.total_cpu_us = stats->GetTotalCpuTime().MicroSeconds();
+  for (const auto &phase : stats->GetProto().query_phases()) {
+    for (const auto &table : phase.table_access()) {
+      view.rows_read += table.reads().rows();
+      view.bytes_read += table.reads().bytes();
+      view.rows_affected += table.updates().rows() + table.deletes().rows();
+      view.bytes_affected += table.updates().bytes() + table.deletes().bytes();
+    }
+  }
+
+  auto plan = stats->GetPlan();
+  last.plan = plan ? std::move(*plan) : std::string();
+  view.plan = plan ? last.plan.c_str() : nullptr;
+  auto ast = stats->GetAst();
+  last.ast = ast ? std::move(*ast) : std::string();
+  view.ast = ast ? last.ast.c_str() : nullptr;
+}
+
+void count_result_set(const NYdb::TResultSet &rset) {
+  if (!ydb_metrics_enabled()) {
+    return;
+  }
+  ydb_metrics_add(YDB_METRIC_ROWS_RETURNED, rset.RowsCount());
+  if (ydb_metrics_bytes_enabled()) {
+    ydb_metrics_add(YDB_METRIC_BYTES_RETURNED,
+                    NYdb::TProtoAccessor::GetProto(rset).ByteSizeLong());
+  }
+}
+
+YdbArenaPtr<YdbResultSets>
+collect_result_sets(const NYdb::NQuery::TExecuteQueryResult &result,
+                    const YdbDriver *drv) {
+  return ydb_collect_result_sets(result.GetResultSets(),
+                                 ydb_driver_tracer(drv));
+}
+
+bool tx_settings_from_mode(ydb_tx_mode_t tx_mode,
+                           NYdb::NQuery::TTxSettings *settings) {
+  switch (tx_mode) {
+  case YDB_TX_SERIALIZABLE_RW:
+    *settings = NYdb::NQuery::TTxSettings::SerializableRW();
+    return true;
+  case YDB_TX_SNAPSHOT_RO:
+    *settings = NYdb::NQuery::TTxSettings::SnapshotRO();
+    return true;
+  case YDB_TX_STALE_RO:
+    *settings = NYdb::NQuery::TTxSettings::StaleRO();
+    return true;
+  case YDB_TX_ONLINE_RO:
+    *settings = NYdb::NQuery::TTxSettings::OnlineRO();
+    return true;
+  case YDB_TX_SNAPSHOT_RW:
+    *settings = NYdb::NQuery::TTxSettings::SnapshotRW();
+    return true;
+  default:
+    return false;
+  }
+}
+
+// the transaction inherits exec settings and tracer from qc
+ydb_status_t begin_tx_on_session(NYdb::NQuery::TSession session,
+                                 const NYdb::NQuery::TTxSettings &settings,
+                                 bool lazy, const YdbQueryClient *qc,
+                                 YdbQueryTransaction **out_tx,
+                                 YdbResultDetails *rd) {
+  if (lazy) {
+    // BeginTransaction is skipped; the first execute sends BeginTx inline
+    auto *wrapped =
+        new (std::nothrow) YdbQueryTransaction(std::move(session), settings);
+    if (!wrapped) {
+      return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                     "failed to allocate query transaction");
+    }
+    wrapped->exec = client_exec(qc);
+    wrapped->parent_driver = qc->parent_driver;
+    wrapped->parent_client = qc;
+    *out_tx = wrapped;
+    return YDB_OK;
+  }
+
+  YdbSpan span(ydb_driver_tracer(qc->parent_driver), "ydb.BeginTransaction",
+               {{"db.system", "ydb"}});
+  auto tx_result =
+      session
+          .BeginTransaction(settings,
+                            request_settings<NYdb::NQuery::TBeginTxSettings>(
+                                client_exec(qc).get()))
+          .GetValueSync();
+  span.end(status_to_ydb_code(tx_result.GetStatus()));
+  if (!tx_result.IsSuccess()) {
+    return ydb_fill_from_status(rd, tx_result);
+  }
+
+  auto tx = tx_result.GetTransaction();
+  auto *wrapped = new (std::nothrow)
+      YdbQueryTransaction(std::move(session), std::move(tx));
+  if (!wrapped) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "failed to allocate query transaction");
+  }
+  wrapped->exec = client_exec(qc);
+  wrapped->parent_driver = qc->parent_driver;
+  wrapped->parent_client = qc;
+
+  *out_tx = wrapped;
+  return YDB_OK;
+}
+
+NYdb::TRetryOperationSettings
+retry_operation_settings(const YdbQueryRetrySettings *rs) {
+  NYdb::TRetryOperationSettings settings;
+  if (!rs) {
+    return settings;
+  }
+  settings.MaxRetries(rs->max_retries);
+  const auto fast = ydb_retry_backoff_capped(rs->fast, rs->max_backoff_ms);
+  if (fast.slot_ms > 0) {
+    settings.FastBackoffSettings(
+        NYdb::NRetry::TBackoffSettings()
+            .SlotDuration(TDuration::MilliSeconds(fast.slot_ms))
+            .Ceiling(fast.ceiling)
+            .UncertainRatio(rs->jitter));
+  }
+  const auto slow = ydb_retry_backoff_capped(rs->slow, rs->max_backoff_ms);
+  if (slow.slot_ms > 0) {
+    settings.SlowBackoffSettings(
+        NYdb::NRetry::TBackoffSettings()
+            .SlotDuration(TDuration::MilliSeconds(slow.slot_ms))
+            .Ceiling(slow.ceiling)
+            .UncertainRatio(rs->jitter));
+  }
+  if (rs->deadline_ms > 0) {
+    settings.MaxTimeout(TDuration::MilliSeconds(rs->deadline_ms));
+  }
+  settings.Idempotent(rs->idempotent);
+  return settings;
+}
+
+enum class BackoffClass { None, Instant, Fast, Slow };
+
+BackoffClass backoff_class(const YdbResultDetails *rd) {
+  using NYdb::EStatus;
+  if (rd->sdk_status == 0) {
+    // no SDK status recorded, fall back to the coarse binding code
+    return ydb_is_status_retriable(rd->code) ? BackoffClass::Fast
+                                             : BackoffClass::None;
+  }
+  switch (static_cast<EStatus>(rd->sdk_status)) {
+  case EStatus::BAD_SESSION:
+  case EStatus::SESSION_EXPIRED:
+    return BackoffClass::Instant;
+  case EStatus::ABORTED:
+  case EStatus::SESSION_BUSY:
+  case EStatus::UNAVAILABLE:
+  case EStatus::TRANSPORT_UNAVAILABLE:
+  case EStatus::CLIENT_DISCOVERY_FAILED:
+    return BackoffClass::Fast;
+  case EStatus::OVERLOADED:
+  case EStatus::CLIENT_RESOURCE_EXHAUSTED:
+    return BackoffClass::Slow;
+  default:
+    return BackoffClass::None;
+  }
+}
+
+uint64_t backoff_delay_us(const YdbQueryRetrySettings *rs,
+                          const YdbRetryBackoff &backoff) {
+  const uint32_t shift = std::min({rs->current_retries, backoff.ceiling, 30u});
+  const uint64_t slot_us = static_cast<uint64_t>(backoff.slot_ms) * 1000;
+  uint64_t delay = slot_us > (UINT64_MAX >> shift) ? UINT64_MAX
+                                                  : slot_us << shift;
+  if (rs->max_backoff_ms > 0) {
+    delay = std::min<uint64_t>(delay,
+                               static_cast<uint64_t>(rs->max_backoff_ms) * 1000);
+  }
+  if (rs->jitter > 0 && delay > 0) {
+    thread_local std::minstd_rand rng{std::random_device{}()};
+    const auto spread = static_cast<uint64_t>(static_cast<double>(delay) *
+                                              std::clamp(rs->jitter, 0.0, 1.0));
+    delay -= std::uniform_int_distribution<uint64_t>(0, spread)(rng);
+  }
+  return delay;
+}
+
+// callers own the try/catch around these two
+ydb_status_t execute_no_tx(YdbQueryClient *qc, const std::string &yql,
+                           const YdbQueryParams *params,
+                           YdbResultSets **out_results, YdbResultDetails *rd) {
+  const auto sdk_params = build_params(params);
+
+  // the client-level call takes a session from the pool inside the SDK
+  const auto tx_control = NYdb::NQuery::TTxControl::NoTx();
+  const auto settings = execute_settings(client_exec(qc).get());
+  YdbMetricsTimer timer(YDB_METRIC_EXECUTE);
+  YdbSpan span = ydb_query_span(qc->parent_driver, yql);
+  auto result =
+      sdk_params
+          ? qc->client->ExecuteQuery(yql, tx_control, *sdk_params, settings)
+                .ExtractValueSync()
+          : qc->client->ExecuteQuery(yql, tx_control, settings)
+                .ExtractValueSync();
+  timer.end();
+
+  record_stats(result.GetStats());
+  const ydb_status_t code = ydb_fill_from_status(rd, result);
+  span.end(code);
+  if (!result.IsSuccess()) {
+    return code;
+  }
+
+  if (out_results) {
+    *out_results =
+        collect_result_sets(result, qc->parent_driver).release();
+  }
+  return YDB_OK;
+}
+
+// begin and commit ride along with the statement when possible
+ydb_status_t tx_control_for(const YdbQueryTransaction *tx, bool commit,
+                            std::optional<NYdb::NQuery::TTxControl> *out,
+                            YdbResultDetails *rd) {
+  if (tx->committed) {
+    return ydb_result_details_fail(rd, YDB_ERR_ALREADY_DONE,
+                                   "transaction is already committed");
+  }
+  if (tx->rolled_back) {
+    return ydb_result_details_fail(rd, YDB_ERR_ALREADY_DONE,
+                                   "transaction is already rolled back");
+  }
+  if (!tx->tx.has_value()) {
+    out->emplace(
+        NYdb::NQuery::TTxControl::BeginTx(tx->settings).CommitTx(commit));
+    return YDB_OK;
+  }
+  if (!tx->tx->IsActive()) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "transaction is not active");
+  }
+  out->emplace(NYdb::NQuery::TTxControl::Tx(*tx->tx).CommitTx(commit));
+  return YDB_OK;
+}
+
+ydb_status_t execute_in_tx(YdbQueryTransaction *tx, const std::string &yql,
+                           const YdbQueryParams *params, bool commit,
+                           YdbResultSets **out_results, YdbResultDetails *rd) {
+  std::optional<NYdb::NQuery::TTxControl> tx_control;
+  if (const auto status = tx_control_for(tx, commit, &tx_control, rd);
+      status != YDB_OK) {
+    return status;
+  }
+
+  const auto sdk_params = build_params(params);
+
+  const auto settings = execute_settings(tx->exec.get());
+  YdbMetricsTimer timer(YDB_METRIC_EXECUTE);
+  YdbSpan span = ydb_query_span(tx->parent_driver, yql);
+  auto result =
+      sdk_params
+          ? tx->session.ExecuteQuery(yql, *tx_control, *sdk_params, settings)
+                .ExtractValueSync()
+          : tx->session.ExecuteQuery(yql, *tx_control, settings)
+                .ExtractValueSync();
+  timer.end();
+
+  record_stats(result.GetStats());
+  const ydb_status_t code = ydb_fill_from_status(rd, result);
+  span.end(code);
+  if (!result.IsSuccess()) {
+    return code;
+  }
+
+  if (!tx->tx.has_value()) {
+    tx->tx = result.GetTransaction();
+  }
+  tx->committed = commit;
+
+  if (out_results) {
+    *out_results =
+        collect_result_sets(result, tx->parent_driver).release();
+  }
+  return YDB_OK;
+}
+
+YdbQueryFuture *wrap_future(NYdb::NQuery::TAsyncExecuteQueryResult future,
+                            YdbDriver *drv, YdbResultDetails *rd) {
+  if (ydb_metrics_enabled()) {
+    future.Subscribe([start = std::chrono::steady_clock::now()](
+                         const NYdb::NQuery::TAsyncExecuteQueryResult &) {
+      ydb_metrics_record(YDB_METRIC_EXECUTE,
+                         std::chrono::steady_clock::now() - start);
+    });
+  }
+  auto *wrapped = new (std::nothrow) YdbQueryFuture(std::move(future));
+  if (!wrapped) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                            "failed to allocate query future");
+    return nullptr;
+  }
+  wrapped->parent_driver = drv;
+  return wrapped;
+}
+
+ydb_status_t begin_client_tx(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
+                             bool lazy, YdbQueryTransaction **out_tx,
+                             YdbResultDetails *rd) {
+  try {
+    if (!qc || !out_tx) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client or out_tx is null");
+    }
+
+    *out_tx = nullptr;
+    if (tx_mode == YDB_TX_NONE) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "transaction mode must not be NONE");
+    }
+
+    NYdb::NQuery::TTxSettings settings;
+    if (!tx_settings_from_mode(tx_mode, &settings)) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "unsupported transaction mode");
+    }
+
+    auto session_result = [&] {
+      YdbMetricsTimer timer(YDB_METRIC_GET_SESSION);
+      YdbSpan span(ydb_driver_tracer(qc->parent_driver), "ydb.GetSession",
+                   {{"db.system", "ydb"}});
+      auto result =
+          qc->client
+              ->GetSession(
+                  request_settings<NYdb::NQuery::TCreateSessionSettings>(
+                      client_exec(qc).get()))
+              .GetValueSync();
+      span.end(status_to_ydb_code(result.GetStatus()));
+      return result;
+    }();
+    if (!session_result.IsSuccess()) {
+      return ydb_fill_from_status(rd, session_result);
+    }
+
+    return begin_tx_on_session(session_result.GetSession(), settings, lazy,
+                               qc, out_tx, rd);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+} // namespace
 
 extern "C" {
 
 YdbQueryClient *ydb_query_client_create(YdbDriver *drv, YdbResultDetails *rd) {
   try {
-    if (!drv || !drv->driver) {
+    if (!drv || !drv->query_client) {
       ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "driver is null");
       return nullptr;
     }
@@ -31,7 +459,8 @@ YdbQueryClient *ydb_query_client_create(YdbDriver *drv, YdbResultDetails *rd) {
       return nullptr;
     }
 
-    qc->client = std::make_unique<NYdb::NQuery::TQueryClient>(*drv->driver);
+    qc->client =
+        std::make_unique<NYdb::NQuery::TQueryClient>(*drv->query_client);
     qc->parent_driver = drv;
     return qc;
   } catch (const std::exception &e) {
@@ -59,109 +488,108 @@ ydb_status_t ydb_query_NOtx_execute(YdbQueryClient *qc, const char *yql,
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "query client or yql is null");
     }
+    return execute_no_tx(qc, yql, params, out_results, result_details);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
 
-    std::optional<NYdb::TParams> sdk_params;
-    if (params) {
-      sdk_params = const_cast<YdbQueryParams *>(params)->builder.Build();
+ydb_status_t ydb_query_prepare(YdbQueryClient *qc, const char *yql,
+                               YdbPreparedQuery **out_query,
+                               YdbResultDetails *rd) {
+  try {
+    if (!qc || !yql || !out_query) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client, yql or out_query is null");
     }
 
-    auto resultsets_out = std::make_unique<YdbResultSets>();
-    auto session_result = qc->client->GetSession().GetValueSync();
-    ydb_status_t code = ydb_fill_from_status(result_details, session_result);
-    if (session_result.IsSuccess()) {
-      auto session = session_result.GetSession();
-      auto result =
-          sdk_params.has_value()
-              ? session
-                    .ExecuteQuery(yql, NYdb::NQuery::TTxControl::NoTx(),
-                                  *sdk_params)
-                    .ExtractValueSync()
-              : session.ExecuteQuery(yql, NYdb::NQuery::TTxControl::NoTx())
-                    .ExtractValueSync();
-
-      code = ydb_fill_from_status(result_details, result);
-      if (result.IsSuccess()) {
-        for (auto &rset : result.GetResultSets()) {
-          resultsets_out->sets.push_back(std::make_unique<YdbResultSet>(rset));
-        }
-      } else {
-        return code;
-      }
-    } else {
-      return code;
+    if (std::shared_lock lock(qc->prepared_mutex);
+        const auto it = qc->prepared.find(std::string_view(yql));
+        it != qc->prepared.end()) {
+      *out_query = it->second.get();
+      return YDB_OK;
     }
 
-    if (out_results) {
-      *out_results = resultsets_out.release();
+    auto pq = std::make_unique<YdbPreparedQuery>();
+    pq->text = yql;
+    pq->parent_client = qc;
+    std::unique_lock lock(qc->prepared_mutex);
+    // another thread may have prepared the same text since the lookup
+    auto it = qc->prepared.find(std::string_view(yql));
+    if (it == qc->prepared.end()) {
+      // handles are raw pointers held by callers, so nothing is evicted
+      // behind their back; a full cache is an error until they unprepare
+      if (qc->prepared.size() >=
+          qc->prepared_limit.load(std::memory_order_relaxed)) {
+        return ydb_result_details_fail(rd, YDB_ERR_RESOURCE_EXHAUSTED,
+                                       "prepared query cache is full");
+      }
+      const std::string_view key(pq->text);
+      it = qc->prepared.emplace(key, std::move(pq)).first;
     }
-
+    *out_query = it->second.get();
     return YDB_OK;
   } catch (const std::exception &e) {
-    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
   } catch (...) {
-    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL,
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
                                    "uncaught C++ exception");
   }
 }
 
-ydb_status_t ydb_query_begin_tx(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
-                                YdbQueryTransaction **out_tx,
-                                YdbResultDetails *rd) {
+ydb_status_t ydb_query_unprepare(YdbQueryClient *qc, YdbPreparedQuery *pq,
+                                 YdbResultDetails *rd) {
   try {
-    if (!qc || !out_tx) {
-      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
-                                     "query client or out_tx is null");
-    }
-
-    *out_tx = nullptr;
-    if (tx_mode == YDB_TX_NONE) {
+    if (!qc || !pq) {
       return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
-                                     "transaction mode must not be NONE");
+                                     "query client or prepared query is null");
     }
-
-    NYdb::NQuery::TTxSettings settings;
-    switch (tx_mode) {
-    case YDB_TX_SERIALIZABLE_RW:
-      settings = NYdb::NQuery::TTxSettings::SerializableRW();
-      break;
-    case YDB_TX_SNAPSHOT_RO:
-      settings = NYdb::NQuery::TTxSettings::SnapshotRO();
-      break;
-    case YDB_TX_STALE_RO:
-      settings = NYdb::NQuery::TTxSettings::StaleRO();
-      break;
-    case YDB_TX_ONLINE_RO:
-      settings = NYdb::NQuery::TTxSettings::OnlineRO();
-      break;
-    case YDB_TX_SNAPSHOT_RW:
-      settings = NYdb::NQuery::TTxSettings::SnapshotRW();
-      break;
-    default:
-      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
-                                     "unsupported transaction mode");
+    std::unique_lock lock(qc->prepared_mutex);
+    const auto it = qc->prepared.find(std::string_view(pq->text));
+    if (it == qc->prepared.end() || it->second.get() != pq) {
+      return ydb_result_details_fail(rd, YDB_ERR_NOT_FOUND,
+                                     "prepared query is not in this client");
     }
+    qc->prepared.erase(it);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
 
-    auto session_result = qc->client->GetSession().GetValueSync();
-    if (!session_result.IsSuccess()) {
-      return ydb_fill_from_status(rd, session_result);
-    }
+ydb_status_t ydb_query_client_set_prepared_limit(YdbQueryClient *qc,
+                                                 size_t limit,
+                                                 YdbResultDetails *rd) {
+  if (!qc || limit == 0) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "query client is null or limit is 0");
+  }
+  qc->prepared_limit.store(limit, std::memory_order_relaxed);
+  return YDB_OK;
+}
 
-    auto session = session_result.GetSession();
-    auto tx_result = session.BeginTransaction(settings).GetValueSync();
-    if (!tx_result.IsSuccess()) {
-      return ydb_fill_from_status(rd, tx_result);
+ydb_status_t ydb_query_execute_prepared(YdbQueryClient *qc,
+                                        const YdbPreparedQuery *pq,
+                                        const YdbQueryParams *params,
+                                        YdbResultSets **out_results,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!qc || !pq) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client or prepared query is null");
     }
-
-    auto tx = tx_result.GetTransaction();
-    auto *wrapped = new (std::nothrow)
-        YdbQueryTransaction(std::move(session), std::move(tx));
-    if (!wrapped) {
-      return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
-                                     "failed to allocate query transaction");
+    if (pq->parent_client != qc) {
+      return ydb_result_details_fail(
+          rd, YDB_ERR_BAD_REQUEST,
+          "prepared query belongs to another query client");
     }
-
-    *out_tx = wrapped;
-    return YDB_OK;
+    return execute_no_tx(qc, pq->text, params, out_results, rd);
   } catch (const std::exception &e) {
     return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
   } catch (...) {
@@ -170,6 +598,18 @@ ydb_status_t ydb_query_begin_tx(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
   }
 }
 
+ydb_status_t ydb_query_begin_tx(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
+                                YdbQueryTransaction **out_tx,
+                                YdbResultDetails *rd) {
+  return begin_client_tx(qc, tx_mode, false, out_tx, rd);
+}
+
+ydb_status_t ydb_query_begin_tx_lazy(YdbQueryClient *qc, ydb_tx_mode_t tx_mode,
+                                     YdbQueryTransaction **out_tx,
+                                     YdbResultDetails *rd) {
+  return begin_client_tx(qc, tx_mode, true, out_tx, rd);
+}
+
 ydb_status_t ydb_query_tx_execute(YdbQueryTransaction *tx, const char *yql,
                                   const YdbQueryParams *params,
                                   YdbResultSets **out_results,
@@ -179,44 +619,82 @@ ydb_status_t ydb_query_tx_execute(YdbQueryTransaction *tx, const char *yql,
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "transaction or yql is null");
     }
-    if (!tx->tx.IsActive()) {
-      return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
-                                     "transaction is not active");
+    return execute_in_tx(tx, yql, params, false, out_results,
+                         result_details);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+ydb_status_t ydb_query_tx_execute_prepared(YdbQueryTransaction *tx,
+                                           const YdbPreparedQuery *pq,
+                                           const YdbQueryParams *params,
+                                           YdbResultSets **out_results,
+                                           YdbResultDetails *rd) {
+  try {
+    if (!tx || !pq) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "transaction or prepared query is null");
     }
-
-    std::optional<NYdb::TParams> sdk_params;
-    if (params) {
-      sdk_params = const_cast<YdbQueryParams *>(params)->builder.Build();
+    if (pq->parent_client != tx->parent_client) {
+      return ydb_result_details_fail(
+          rd, YDB_ERR_BAD_REQUEST,
+          "prepared query belongs to another query client");
     }
+    return execute_in_tx(tx, pq->text, params, false, out_results, rd);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
 
-    auto tx_control = NYdb::NQuery::TTxControl::Tx(tx->tx);
-    auto result_sets = std::make_unique<YdbResultSets>();
-    auto result =
-        sdk_params.has_value()
-            ? tx->session.ExecuteQuery(yql, tx_control, *sdk_params)
-                  .ExtractValueSync()
-            : tx->session.ExecuteQuery(yql, tx_control).ExtractValueSync();
-
-    const ydb_status_t code = ydb_fill_from_status(result_details, result);
-    if (!result.IsSuccess()) {
-      return code;
+ydb_status_t ydb_query_tx_execute_commit(YdbQueryTransaction *tx,
+                                         const char *yql,
+                                         const YdbQueryParams *params,
+                                         YdbResultSets **out_results,
+                                         YdbResultDetails *rd) {
+  try {
+    if (!tx || !yql) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "transaction or yql is null");
     }
+    return execute_in_tx(tx, yql, params, true, out_results, rd);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
 
-    for (auto &rset : result.GetResultSets()) {
-      result_sets->sets.push_back(std::make_unique<YdbResultSet>(rset));
+ydb_status_t ydb_query_tx_execute_prepared_commit(YdbQueryTransaction *tx,
+                                                  const YdbPreparedQuery *pq,
+                                                  const YdbQueryParams *params,
+                                                  YdbResultSets **out_results,
+                                                  YdbResultDetails *rd) {
+  try {
+    if (!tx || !pq) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "transaction or prepared query is null");
     }
-
-    if (out_results) {
-      *out_results = result_sets.release();
+    if (pq->parent_client != tx->parent_client) {
+      return ydb_result_details_fail(
+          rd, YDB_ERR_BAD_REQUEST,
+          "prepared query belongs to another query client");
     }
-    return YDB_OK;
+    return execute_in_tx(tx, pq->text, params, true, out_results, rd);
   } catch (const std::exception &e) {
-    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
   } catch (...) {
-    return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL,
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
                                    "uncaught C++ exception");
   }
 }
+
 ydb_status_t ydb_query_tx_commit(YdbQueryTransaction *tx,
                                  YdbResultDetails *result_details) {
   try {
@@ -224,12 +702,33 @@ ydb_status_t ydb_query_tx_commit(YdbQueryTransaction *tx,
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "transaction is null");
     }
-    if (!tx->tx.IsActive()) {
+    if (tx->committed) {
+      return ydb_result_details_fail(result_details, YDB_ERR_ALREADY_DONE,
+                                     "transaction is already committed");
+    }
+    if (tx->rolled_back) {
+      return ydb_result_details_fail(result_details, YDB_ERR_ALREADY_DONE,
+                                     "transaction is already rolled back");
+    }
+    if (!tx->tx.has_value()) {
+      // lazily begun and never executed: nothing reached the server
+      tx->committed = true;
+      return YDB_OK;
+    }
+    if (!tx->tx->IsActive()) {
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "transaction is not active");
     }
-    auto result = tx->tx.Commit().GetValueSync();
-    return ydb_fill_from_status(result_details, result);
+    YdbMetricsTimer timer(YDB_METRIC_COMMIT);
+    YdbSpan span(ydb_driver_tracer(tx->parent_driver), "ydb.Commit",
+                 {{"db.system", "ydb"}});
+    auto result =
+        tx->tx
+            ->Commit(request_settings<NYdb::NQuery::TCommitTxSettings>(
+                tx->exec.get()))
+            .GetValueSync();
+    tx->committed = result.IsSuccess();
+    return span.end(ydb_fill_from_status(result_details, result));
   } catch (const std::exception &e) {
     return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
   } catch (...) {
@@ -244,12 +743,33 @@ ydb_status_t ydb_query_tx_rollback(YdbQueryTransaction *tx,
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "transaction is null");
     }
-    if (!tx->tx.IsActive()) {
+    if (tx->committed) {
+      return ydb_result_details_fail(result_details, YDB_ERR_ALREADY_DONE,
+                                     "transaction is already committed");
+    }
+    if (tx->rolled_back) {
+      return ydb_result_details_fail(result_details, YDB_ERR_ALREADY_DONE,
+                                     "transaction is already rolled back");
+    }
+    if (!tx->tx.has_value()) {
+      // nothing reached the server, but a later execute must not begin anew
+      tx->rolled_back = true;
+      return YDB_OK;
+    }
+    if (!tx->tx->IsActive()) {
       return ydb_result_details_fail(result_details, YDB_ERR_BAD_REQUEST,
                                      "transaction is not active");
     }
-    auto result = tx->tx.Rollback().GetValueSync();
-    return ydb_fill_from_status(result_details, result);
+    YdbMetricsTimer timer(YDB_METRIC_ROLLBACK);
+    YdbSpan span(ydb_driver_tracer(tx->parent_driver), "ydb.Rollback",
+                 {{"db.system", "ydb"}});
+    auto result =
+        tx->tx
+            ->Rollback(request_settings<NYdb::NQuery::TRollbackTxSettings>(
+                tx->exec.get()))
+            .GetValueSync();
+    tx->rolled_back = result.IsSuccess();
+    return span.end(ydb_fill_from_status(result_details, result));
   } catch (const std::exception &e) {
     return ydb_result_details_fail(result_details, YDB_ERR_INTERNAL, e.what());
   } catch (...) {
@@ -272,17 +792,450 @@ void ydb_query_tx_free(YdbQueryTransaction *tx,
   }
 }
 
-/*
-> settings сейчас это пользовательский интерфейс, который обрабатывается в
-отрыве от функций выполнения действий с таблицами. Для того, что бы понять,
-можно делать ретрай или нет, существует функция `ydb_is_status_retriable`,
-которая определяет саму возможность ретрая, а так же итеративно вызываемая
-`ydb_query_perform_retry`, которая оперирует структурой для ретраев
-*/
+ydb_status_t ydb_query_last_stats(const YdbQueryStats **out,
+                                  YdbResultDetails *rd) {
+  if (!out) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "out is null");
+  }
+  *out = nullptr;
+  if (!last_stats.valid) {
+    return ydb_result_details_fail(rd, YDB_ERR_NOT_FOUND,
+                                   "last query returned no stats");
+  }
+  *out = &last_stats.view;
+  return YDB_OK;
+}
 
-YdbQueryRetrySettings *ydb_query_retry_settings_create(uint32_t max_retries,
-                                                       uint32_t timeout_ms,
-                                                       YdbResultDetails *rd) {
+YdbExecSettings *ydb_exec_settings_create(YdbResultDetails *rd) {
+  auto *s = new (std::nothrow) YdbExecSettings();
+  if (!s) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                            "failed to allocate exec settings");
+  }
+  return s;
+}
+
+void ydb_exec_settings_free(YdbExecSettings *s) { delete s; }
+
+ydb_status_t ydb_exec_settings_set_client_timeout(YdbExecSettings *s,
+                                                  uint32_t timeout_ms,
+                                                  YdbResultDetails *rd) {
+  if (!s) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "exec settings is null");
+  }
+  s->client_timeout_ms = timeout_ms;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_exec_settings_set_resource_pool(YdbExecSettings *s,
+                                                 const char *pool,
+                                                 YdbResultDetails *rd) {
+  if (!s) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "exec settings is null");
+  }
+  try {
+    if (pool && *pool) {
+      s->resource_pool = pool;
+    } else {
+      s->resource_pool.reset();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+ydb_status_t ydb_exec_settings_set_stats_mode(YdbExecSettings *s,
+                                              ydb_stats_mode_t mode,
+                                              YdbResultDetails *rd) {
+  using NYdb::NQuery::EStatsMode;
+  if (!s) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "exec settings is null");
+  }
+  switch (mode) {
+  case YDB_STATS_NONE:
+    s->stats_mode = EStatsMode::None;
+    return YDB_OK;
+  case YDB_STATS_BASIC:
+    s->stats_mode = EStatsMode::Basic;
+    return YDB_OK;
+  case YDB_STATS_FULL:
+    s->stats_mode = EStatsMode::Full;
+    return YDB_OK;
+  case YDB_STATS_PROFILE:
+    s->stats_mode = EStatsMode::Profile;
+    return YDB_OK;
+  default:
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "unsupported stats mode");
+  }
+}
+
+ydb_status_t ydb_query_client_set_exec_settings(YdbQueryClient *qc,
+                                                const YdbExecSettings *s,
+                                                YdbResultDetails *rd) {
+  try {
+    if (!qc) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client is null");
+    }
+    qc->exec.store(copy_exec_settings(s), std::memory_order_release);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_tx_set_exec_settings(YdbQueryTransaction *tx,
+                                            const YdbExecSettings *s,
+                                            YdbResultDetails *rd) {
+  try {
+    if (!tx) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "transaction is null");
+    }
+    tx->exec = copy_exec_settings(s);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_session_acquire(YdbQueryClient *qc,
+                                       YdbSession **out_session,
+                                       YdbResultDetails *rd) {
+  try {
+    if (!qc || !out_session) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client or out_session is null");
+    }
+
+    *out_session = nullptr;
+    auto session_result = [&] {
+      YdbMetricsTimer timer(YDB_METRIC_GET_SESSION);
+      YdbSpan span(ydb_driver_tracer(qc->parent_driver), "ydb.GetSession",
+                   {{"db.system", "ydb"}});
+      auto result =
+          qc->client
+              ->GetSession(
+                  request_settings<NYdb::NQuery::TCreateSessionSettings>(
+                      client_exec(qc).get()))
+              .GetValueSync();
+      span.end(status_to_ydb_code(result.GetStatus()));
+      return result;
+    }();
+    if (!session_result.IsSuccess()) {
+      return ydb_fill_from_status(rd, session_result);
+    }
+
+    auto *wrapped =
+        new (std::nothrow) YdbSession(session_result.GetSession(), qc);
+    if (!wrapped) {
+      return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                     "failed to allocate session");
+    }
+
+    *out_session = wrapped;
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_query_session_release(YdbSession *s, YdbResultDetails *rd) {
+  try {
+    // dropping the last TSession handle returns it to the client pool
+    delete s;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_session_execute(YdbSession *s, const char *yql,
+                                       const YdbQueryParams *params,
+                                       YdbResultSets **out_results,
+                                       YdbResultDetails *rd) {
+  try {
+    if (!s || !yql) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "session or yql is null");
+    }
+
+    const auto sdk_params = build_params(params);
+    const auto tx_control = NYdb::NQuery::TTxControl::NoTx();
+    const auto settings = execute_settings(client_exec(s->parent_client).get());
+    YdbMetricsTimer timer(YDB_METRIC_EXECUTE);
+    YdbSpan span = ydb_query_span(s->parent_client->parent_driver, yql);
+    auto result =
+        sdk_params
+            ? s->session.ExecuteQuery(yql, tx_control, *sdk_params, settings)
+                  .ExtractValueSync()
+            : s->session.ExecuteQuery(yql, tx_control, settings)
+                  .ExtractValueSync();
+    timer.end();
+
+    record_stats(result.GetStats());
+    const ydb_status_t code = ydb_fill_from_status(rd, result);
+    span.end(code);
+    if (!result.IsSuccess()) {
+      return code;
+    }
+
+    if (out_results) {
+      *out_results =
+          collect_result_sets(result, s->parent_client->parent_driver)
+              .release();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_session_begin_tx(YdbSession *s, ydb_tx_mode_t tx_mode,
+                                        YdbQueryTransaction **out_tx,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!s || !out_tx) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "session or out_tx is null");
+    }
+
+    *out_tx = nullptr;
+    NYdb::NQuery::TTxSettings settings;
+    if (!tx_settings_from_mode(tx_mode, &settings)) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "unsupported transaction mode");
+    }
+    return begin_tx_on_session(s->session, settings, false,
+                               s->parent_client, out_tx, rd);
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+YdbQueryFuture *ydb_query_execute_async(YdbQueryClient *qc, const char *yql,
+                                        const YdbQueryParams *params,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!qc || !yql) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "query client or yql is null");
+      return nullptr;
+    }
+
+    const auto sdk_params = build_params(params);
+    const auto tx_control = NYdb::NQuery::TTxControl::NoTx();
+    const auto settings = execute_settings(client_exec(qc).get());
+    auto future =
+        sdk_params
+            ? qc->client->ExecuteQuery(yql, tx_control, *sdk_params, settings)
+            : qc->client->ExecuteQuery(yql, tx_control, settings);
+    return wrap_future(std::move(future), qc->parent_driver, rd);
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+YdbQueryFuture *ydb_query_tx_execute_async(YdbQueryTransaction *tx,
+                                           const char *yql,
+                                           const YdbQueryParams *params,
+                                           YdbResultDetails *rd) {
+  try {
+    if (!tx || !yql) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "transaction or yql is null");
+      return nullptr;
+    }
+    if (!tx->tx.has_value() && !tx->committed && !tx->rolled_back) {
+      // the transaction id would only be known once the future resolves
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "lazy transaction must begin synchronously");
+      return nullptr;
+    }
+    std::optional<NYdb::NQuery::TTxControl> tx_control;
+    if (tx_control_for(tx, false, &tx_control, rd) != YDB_OK) {
+      return nullptr;
+    }
+
+    const auto sdk_params = build_params(params);
+    const auto settings = execute_settings(tx->exec.get());
+    auto future =
+        sdk_params
+            ? tx->session.ExecuteQuery(yql, *tx_control, *sdk_params, settings)
+            : tx->session.ExecuteQuery(yql, *tx_control, settings);
+    return wrap_future(std::move(future), tx->parent_driver, rd);
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+int ydb_query_future_is_ready(const YdbQueryFuture *f) {
+  if (!f) {
+    return 0;
+  }
+  {
+    std::lock_guard lock(f->state->mutex);
+    if (f->state->cancelled) {
+      return 1;
+    }
+  }
+  return f->future.HasValue() || f->future.HasException() ? 1 : 0;
+}
+
+ydb_status_t ydb_query_future_wait(YdbQueryFuture *f, uint32_t timeout_ms,
+                                   YdbResultDetails *rd) {
+  try {
+    if (!f) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query future is null");
+    }
+    if (std::lock_guard lock(f->state->mutex); f->state->cancelled) {
+      return ydb_result_details_fail(rd, YDB_ERR_CANCELLED,
+                                     "query future is cancelled");
+    }
+    if (!f->future.Wait(TDuration::MilliSeconds(timeout_ms))) {
+      return ydb_result_details_fail(rd, YDB_ERR_TIMEOUT,
+                                     "query is not finished before timeout");
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_future_on_ready(YdbQueryFuture *f,
+                                       ydb_query_callback_t cb,
+                                       void *user_data, YdbResultDetails *rd) {
+  try {
+    if (!f || !cb) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query future or callback is null");
+    }
+    f->future.Subscribe([f, state = f->state, cb, user_data](
+                            const NYdb::NQuery::TAsyncExecuteQueryResult &) {
+      std::lock_guard lock(state->mutex);
+      if (!state->cancelled) {
+        cb(f, user_data);
+      }
+    });
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_future_get(YdbQueryFuture *f,
+                                  YdbResultSets **out_results,
+                                  YdbResultDetails *rd) {
+  try {
+    if (!f) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query future is null");
+    }
+    if (f->consumed) {
+      return ydb_result_details_fail(rd, YDB_ERR_ALREADY_DONE,
+                                     "query future result is already taken");
+    }
+    if (std::lock_guard lock(f->state->mutex); f->state->cancelled) {
+      return ydb_result_details_fail(rd, YDB_ERR_CANCELLED,
+                                     "query future is cancelled");
+    }
+
+    f->consumed = true;
+    auto result = f->future.ExtractValueSync();
+    record_stats(result.GetStats());
+    const ydb_status_t code = ydb_fill_from_status(rd, result);
+    if (!result.IsSuccess()) {
+      return code;
+    }
+
+    if (out_results) {
+      *out_results =
+          collect_result_sets(result, f->parent_driver).release();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_future_cancel(YdbQueryFuture *f,
+                                     YdbResultDetails *rd) {
+  try {
+    if (!f) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query future is null");
+    }
+    // the SDK cannot abort the call; waits until a running callback returns
+    std::lock_guard lock(f->state->mutex);
+    f->state->cancelled = true;
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_query_future_free(YdbQueryFuture *f) {
+  try {
+    if (f) {
+      std::lock_guard lock(f->state->mutex);
+      f->state->cancelled = true;
+    }
+    delete f;
+  } catch (...) {
+  }
+}
+
+/*
+> settings сейчас это пользовательский интерфейс, который обрабатывается в
+отрыве от функций выполнения действий с таблицами. Для того, что бы понять,
+можно делать ретрай или нет, существует функция `ydb_is_status_retriable`,
+которая определяет саму возможность ретрая, а так же итеративно вызываемая
+`ydb_query_perform_retry`, которая оперирует структурой для ретраев
+*/
+
+YdbQueryRetrySettings *ydb_query_retry_settings_create(uint32_t max_retries,
+                                                       uint32_t timeout_ms,
+                                                       YdbResultDetails *rd) {
   try {
     auto *rs = new (std::nothrow) YdbQueryRetrySettings();
     if (!rs) {
@@ -293,6 +1246,10 @@ YdbQueryRetrySettings *ydb_query_retry_settings_create(uint32_t max_retries,
     rs->max_retries = max_retries;
     rs->current_retries = 0;
     rs->timeout_ms = timeout_ms;
+    // constant delay until a backoff class is configured
+    rs->fast.slot_ms = timeout_ms;
+    rs->slow.slot_ms = timeout_ms;
+    rs->started = std::chrono::steady_clock::now();
     return rs;
   } catch (const std::exception &e) {
     ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
@@ -313,15 +1270,166 @@ void ydb_query_retry_settings_free(YdbQueryRetrySettings *rs,
   }
 }
 
-ydb_status_t ydb_query_perform_retry(YdbQueryRetrySettings *rs,
-                                     YdbResultDetails *rd) {
+ydb_status_t ydb_query_execute_with_retry(YdbQueryClient *qc, const char *yql,
+                                          const YdbQueryParams *params,
+                                          ydb_tx_mode_t tx_mode,
+                                          YdbQueryRetrySettings *rs,
+                                          YdbResultSets **out_results,
+                                          YdbResultDetails *rd) {
   try {
-    if (!rs) {
+    if (!qc || !yql) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "query client or yql is null");
+    }
+
+    NYdb::NQuery::TTxSettings tx_settings;
+    const bool in_tx = tx_mode != YDB_TX_NONE;
+    if (in_tx && !tx_settings_from_mode(tx_mode, &tx_settings)) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "unsupported transaction mode");
+    }
+
+    const auto sdk_params = build_params(params);
+    const auto settings = execute_settings(client_exec(qc).get());
+    const std::string query(yql);
+    uint32_t attempts = 0;
+
+    // every attempt runs as one self-committing statement, so a retry never
+    // has to resume a half-done transaction
+    std::function<NYdb::NQuery::TAsyncExecuteQueryResult(
+        NYdb::NQuery::TSession)>
+        attempt = [&](NYdb::NQuery::TSession session) {
+          ++attempts;
+          const auto tx_control =
+              in_tx ? NYdb::NQuery::TTxControl::BeginTx(tx_settings).CommitTx()
+                    : NYdb::NQuery::TTxControl::NoTx();
+          return sdk_params ? session.ExecuteQuery(query, tx_control,
+                                                   *sdk_params, settings)
+                            : session.ExecuteQuery(query, tx_control, settings);
+        };
+
+    YdbMetricsTimer timer(YDB_METRIC_EXECUTE);
+    YdbSpan span = ydb_query_span(qc->parent_driver, yql);
+    auto result =
+        qc->client->RetryQuery(std::move(attempt), retry_operation_settings(rs))
+            .ExtractValueSync();
+    timer.end();
+    if (attempts > 1) {
+      ydb_metrics_add(YDB_METRIC_RETRY_ATTEMPTS, attempts - 1);
+    }
+    if (rs && attempts > 1) {
+      rs->current_retries += attempts - 1;
+    }
+
+    record_stats(result.GetStats());
+    const ydb_status_t code = ydb_fill_from_status(rd, result);
+    span.end(code);
+    if (!result.IsSuccess()) {
+      return code;
+    }
+
+    if (out_results) {
+      *out_results =
+          collect_result_sets(result, qc->parent_driver).release();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_retry_settings_set_fast_backoff(YdbQueryRetrySettings *rs,
+                                                      uint32_t slot_ms,
+                                                      uint32_t ceiling,
+                                                      YdbResultDetails *rd) {
+  if (!rs) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "retry settings is null");
+  }
+  rs->fast.slot_ms = slot_ms;
+  rs->fast.ceiling = ceiling;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_retry_settings_set_slow_backoff(YdbQueryRetrySettings *rs,
+                                                      uint32_t slot_ms,
+                                                      uint32_t ceiling,
+                                                      YdbResultDetails *rd) {
+  if (!rs) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "retry settings is null");
+  }
+  rs->slow.slot_ms = slot_ms;
+  rs->slow.ceiling = ceiling;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_retry_settings_set_max_backoff(YdbQueryRetrySettings *rs,
+                                                     uint32_t max_backoff_ms,
+                                                     YdbResultDetails *rd) {
+  if (!rs) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "retry settings is null");
+  }
+  rs->max_backoff_ms = max_backoff_ms;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_retry_settings_set_jitter(YdbQueryRetrySettings *rs,
+                                                double ratio,
+                                                YdbResultDetails *rd) {
+  if (!rs || !(ratio >= 0.0 && ratio <= 1.0)) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "jitter ratio must be within [0, 1]");
+  }
+  rs->jitter = ratio;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_retry_settings_set_deadline(YdbQueryRetrySettings *rs,
+                                                  uint32_t deadline_ms,
+                                                  YdbResultDetails *rd) {
+  if (!rs) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "retry settings is null");
+  }
+  rs->deadline_ms = deadline_ms;
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_retry_settings_set_idempotent(YdbQueryRetrySettings *rs,
+                                                    int idempotent,
+                                                    YdbResultDetails *rd) {
+  if (!rs) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "retry settings is null");
+  }
+  rs->idempotent = idempotent != 0;
+  return YDB_OK;
+}
+
+void ydb_query_retry_settings_reset(YdbQueryRetrySettings *rs) {
+  if (!rs) {
+    return;
+  }
+  rs->current_retries = 0;
+  rs->started = std::chrono::steady_clock::now();
+}
+
+ydb_status_t ydb_query_retry_next_delay(YdbQueryRetrySettings *rs,
+                                        uint64_t *out_delay_us,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!rs || !out_delay_us) {
       return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
-                                     "retry settings is null");
+                                     "retry settings or out_delay_us is null");
     }
 
-    if (!rd || !ydb_is_status_retriable(rd->code)) {
+    const BackoffClass cls = rd ? backoff_class(rd) : BackoffClass::None;
+    if (cls == BackoffClass::None) {
       return ydb_result_details_fail(rd, YDB_ERR_RETRY_FAILED,
                                      "retry conditions are not met");
     }
@@ -331,10 +1439,92 @@ ydb_status_t ydb_query_perform_retry(YdbQueryRetrySettings *rs,
                                      "retry limit exceeded");
     }
 
-    if (rs->timeout_ms > 0) {
-      usleep(static_cast<useconds_t>(rs->timeout_ms) * 1000);
+    uint64_t delay_us = 0;
+    if (cls == BackoffClass::Fast) {
+      delay_us = backoff_delay_us(rs, rs->fast);
+    } else if (cls == BackoffClass::Slow) {
+      delay_us = backoff_delay_us(rs, rs->slow);
     }
+
+    if (rs->deadline_ms > 0) {
+      const auto elapsed = std::chrono::steady_clock::now() - rs->started;
+      const auto budget = std::chrono::milliseconds(rs->deadline_ms);
+      if (elapsed + std::chrono::microseconds(delay_us) >= budget) {
+        return ydb_result_details_fail(rd, YDB_ERR_RETRY_FAILED,
+                                       "retry deadline exceeded");
+      }
+    }
+
     rs->current_retries += 1;
+    ydb_metrics_add(YDB_METRIC_RETRY_ATTEMPTS, 1);
+    *out_delay_us = delay_us;
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_query_perform_retry(YdbQueryRetrySettings *rs,
+                                     YdbResultDetails *rd) {
+  uint64_t delay_us = 0;
+  const ydb_status_t code = ydb_query_retry_next_delay(rs, &delay_us, rd);
+  if (code != YDB_OK) {
+    return code;
+  }
+  if (delay_us > 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+  }
+  return YDB_OK;
+}
+
+ydb_status_t ydb_query_stream_execute(YdbQueryClient *qc, const char *yql,
+                                      const YdbQueryParams *params,
+                                      ydb_tx_mode_t tx_mode,
+                                      YdbResultStream **out_stream,
+                                      YdbResultDetails *rd) {
+  try {
+    if (!qc || !yql || !out_stream) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid stream execute arguments");
+    }
+    *out_stream = nullptr;
+
+    NYdb::NQuery::TTxSettings tx_settings;
+    const bool in_tx = tx_mode != YDB_TX_NONE;
+    if (in_tx && !tx_settings_from_mode(tx_mode, &tx_settings)) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "unsupported transaction mode");
+    }
+
+    const auto sdk_params = build_params(params);
+    const auto tx_control =
+        in_tx ? NYdb::NQuery::TTxControl::BeginTx(tx_settings).CommitTx()
+              : NYdb::NQuery::TTxControl::NoTx();
+    const auto settings = execute_settings(client_exec(qc).get());
+    YdbSpan span = ydb_query_span(qc->parent_driver, yql);
+    auto it = sdk_params ? qc->client
+                               ->StreamExecuteQuery(yql, tx_control,
+                                                    *sdk_params, settings)
+                               .ExtractValueSync()
+                         : qc->client->StreamExecuteQuery(yql, tx_control,
+                                                          settings)
+                               .ExtractValueSync();
+    if (!it.IsSuccess()) {
+      return span.end(ydb_fill_from_status(rd, it));
+    }
+    span.end(YDB_OK);
+
+    record_stats(std::nullopt);
+    auto *stream = new (std::nothrow) YdbResultStream(std::move(it));
+    if (!stream) {
+      return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                     "failed to allocate result stream");
+    }
+    stream->tracer = ydb_driver_tracer(qc->parent_driver);
+    *out_stream = stream;
     return YDB_OK;
   } catch (const std::exception &e) {
     return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
@@ -344,4 +1534,91 @@ ydb_status_t ydb_query_perform_retry(YdbQueryRetrySettings *rs,
   }
 }
 
+ydb_status_t ydb_result_stream_next_part(YdbResultStream *stream,
+                                         YdbResultSet **out_set,
+                                         int64_t *out_index,
+                                         YdbResultDetails *rd) {
+  try {
+    if (!stream || !out_set) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "result stream is null");
+    }
+    *out_set = nullptr;
+
+    // parts without a result set only carry stats or progress
+    while (!stream->finished) {
+      auto part = stream->it.ReadNext().ExtractValueSync();
+      if (part.EOS()) {
+        stream->finished = true;
+        break;
+      }
+      if (!part.IsSuccess()) {
+        stream->finished = true;
+        return ydb_fill_from_status(rd, part);
+      }
+      if (part.GetStats()) {
+        // the server sends stats with the final part
+        record_stats(part.GetStats());
+      }
+      if (!part.HasResultSet()) {
+        continue;
+      }
+
+      const int64_t index = part.GetResultSetIndex();
+      count_result_set(part.GetResultSet());
+      auto *set = ydb_arena_new<YdbResultSet>(part.ExtractResultSet());
+      set->tracer = stream->tracer;
+      if (out_index) {
+        *out_index = index;
+      }
+      *out_set = set;
+      return YDB_OK;
+    }
+    return YDB_ERR_NO_MORE_RESULTS;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_result_stream_free(YdbResultStream *stream) {
+  try {
+    delete stream;
+  } catch (...) {
+  }
+}
+
 } // extern "C"
+
+YdbRetryBackoff ydb_retry_backoff_capped(const YdbRetryBackoff &backoff,
+                                         uint32_t max_backoff_ms) {
+  if (max_backoff_ms == 0 || backoff.slot_ms == 0) {
+    return backoff;
+  }
+  YdbRetryBackoff capped;
+  capped.slot_ms = std::min(backoff.slot_ms, max_backoff_ms);
+  const uint32_t ceiling = std::min(backoff.ceiling, 30u);
+  while (capped.ceiling < ceiling &&
+         (static_cast<uint64_t>(capped.slot_ms) << (capped.ceiling + 1)) <=
+             max_backoff_ms) {
+    ++capped.ceiling;
+  }
+  return capped;
+}
+
+YdbArenaPtr<YdbResultSets>
+ydb_collect_result_sets(const std::vector<NYdb::TResultSet> &sets,
+                        const std::shared_ptr<const YdbTracer> &tracer) {
+  YdbArenaPtr<YdbResultSets> result_sets(ydb_arena_new<YdbResultSets>());
+  result_sets->sets.reserve(sets.size());
+  for (const auto &rset : sets) {
+    count_result_set(rset);
+    // a TResultSet copy shares the response protobuf, so no rows are copied
+    auto &set =
+        result_sets->sets.emplace_back(ydb_arena_new<YdbResultSet>(rset));
+    set->tracer = tracer;
+  }
+  return result_sets;
+}
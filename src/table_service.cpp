@@ -0,0 +1,84 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <ydb-cpp-sdk/client/driver/driver.h>
+#include <ydb-cpp-sdk/client/table/table.h>
+#include <ydb-cpp-sdk/client/value/value.h>
+
+#include <memory>
+#include <string>
+
+extern "C" {
+
+YdbTableClient *ydb_table_client_create(YdbDriver *drv, YdbResultDetails *rd) {
+  try {
+    if (!drv || !drv->driver) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "driver is null");
+      return nullptr;
+    }
+
+    auto *tc = new (std::nothrow) YdbTableClient();
+    if (!tc) {
+      ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                              "failed to allocate table client");
+      return nullptr;
+    }
+
+    tc->client = std::make_unique<NYdb::NTable::TTableClient>(*drv->driver);
+    tc->parent_driver = drv;
+    return tc;
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+void ydb_table_client_free(YdbTableClient *tc) {
+  try {
+    delete tc;
+  } catch (...) {
+  }
+}
+
+ydb_status_t ydb_table_bulk_upsert(YdbTableClient *tc, const char *table_path,
+                                   YdbQueryParams *rows,
+                                   const char *param_name,
+                                   YdbResultDetails *rd) {
+  try {
+    if (!tc || !tc->client || !table_path || !rows || !param_name) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid bulk upsert arguments");
+    }
+
+    const NYdb::TValue *value = ydb_query_params_find(rows, param_name);
+    if (!value) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "bulk upsert rows parameter is not set");
+    }
+    if (NYdb::TTypeParser(value->GetType()).GetKind() !=
+        NYdb::TTypeParser::ETypeKind::List) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "bulk upsert rows must be a list");
+    }
+
+    // TValue shares its protobuf, so the copy is cheap and the rows stay
+    // bound if the upsert fails and has to be retried
+    auto status =
+        tc->client->BulkUpsert(table_path, NYdb::TValue(*value)).GetValueSync();
+    if (!status.IsSuccess()) {
+      return ydb_fill_from_status(rd, status);
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+} // extern "C"
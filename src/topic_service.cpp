@@ -0,0 +1,520 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <ydb-cpp-sdk/client/driver/driver.h>
+#include <ydb-cpp-sdk/client/topic/client.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+ydb_topic_ack_state_t
+ack_state(NYdb::NTopic::TWriteSessionEvent::TWriteAck::EEventState state) {
+  using EState = NYdb::NTopic::TWriteSessionEvent::TWriteAck::EEventState;
+  switch (state) {
+  case EState::EES_ALREADY_WRITTEN:
+    return YDB_TOPIC_ACK_ALREADY_WRITTEN;
+  case EState::EES_DISCARDED:
+    return YDB_TOPIC_ACK_DISCARDED;
+  default:
+    return YDB_TOPIC_ACK_WRITTEN;
+  }
+}
+
+NYdb::NTopic::TWriteSessionSettings::TEventHandlers
+writer_handlers(const std::shared_ptr<YdbTopicWriterState> &state) {
+  using NYdb::NTopic::TSessionClosedEvent;
+  using NYdb::NTopic::TWriteSessionEvent;
+
+  NYdb::NTopic::TWriteSessionSettings::TEventHandlers handlers;
+  handlers.ReadyToAcceptHandler(
+      [state](TWriteSessionEvent::TReadyToAcceptEvent &event) {
+        {
+          std::lock_guard lock(state->mutex);
+          state->tokens.push_back(std::move(event.ContinuationToken));
+        }
+        state->ready.notify_all();
+      });
+  handlers.AcksHandler([state](TWriteSessionEvent::TAcksEvent &event) {
+    if (!state->on_ack) {
+      return;
+    }
+    for (const auto &ack : event.Acks) {
+      state->on_ack(ack.SeqNo, ack_state(ack.State), state->user_data);
+    }
+  });
+  handlers.SessionClosedHandler([state](const TSessionClosedEvent &event) {
+    {
+      std::lock_guard lock(state->mutex);
+      state->closed.emplace(event);
+      state->tokens.clear();
+    }
+    state->ready.notify_all();
+  });
+  return handlers;
+}
+
+// answers partition control events; returns true if ev carried data
+bool handle_read_event(NYdb::NTopic::TReadSessionEvent::TEvent &ev,
+                       YdbTopicBatch &batch,
+                       std::optional<NYdb::TStatus> &closed) {
+  using NYdb::NTopic::TReadSessionEvent;
+  if (auto *data = std::get_if<TReadSessionEvent::TDataReceivedEvent>(&ev)) {
+    batch.events.push_back(std::move(*data));
+    return true;
+  }
+  if (auto *start =
+          std::get_if<TReadSessionEvent::TStartPartitionSessionEvent>(&ev)) {
+    start->Confirm();
+  } else if (auto *stop = std::get_if<
+                 TReadSessionEvent::TStopPartitionSessionEvent>(&ev)) {
+    stop->Confirm();
+  } else if (auto *end = std::get_if<
+                 TReadSessionEvent::TEndPartitionSessionEvent>(&ev)) {
+    end->Confirm();
+  } else if (auto *session_closed =
+                 std::get_if<NYdb::NTopic::TSessionClosedEvent>(&ev)) {
+    closed.emplace(*session_closed);
+  }
+  return false;
+}
+
+} // namespace
+
+extern "C" {
+
+YdbTopicClient *ydb_topic_client_create(YdbDriver *drv, YdbResultDetails *rd) {
+  try {
+    if (!drv || !drv->driver) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "driver is null");
+      return nullptr;
+    }
+
+    auto *tc = new (std::nothrow) YdbTopicClient();
+    if (!tc) {
+      ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                              "failed to allocate topic client");
+      return nullptr;
+    }
+
+    tc->client = std::make_unique<NYdb::NTopic::TTopicClient>(*drv->driver);
+    tc->parent_driver = drv;
+    return tc;
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+void ydb_topic_client_free(YdbTopicClient *tc) {
+  try {
+    delete tc;
+  } catch (...) {
+  }
+}
+
+/* ── Writer ──────────────────────────────────────────────────────── */
+
+YdbTopicWriterConfig *ydb_topic_writer_config_create(const char *topic_path,
+                                                     YdbResultDetails *rd) {
+  try {
+    if (!topic_path) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "topic path is null");
+      return nullptr;
+    }
+    auto *cfg = new (std::nothrow) YdbTopicWriterConfig();
+    if (!cfg) {
+      ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                              "failed to allocate topic writer config");
+      return nullptr;
+    }
+    cfg->settings.Path(topic_path);
+    return cfg;
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+void ydb_topic_writer_config_free(YdbTopicWriterConfig *cfg) { delete cfg; }
+
+ydb_status_t ydb_topic_writer_config_set_producer_id(YdbTopicWriterConfig *cfg,
+                                                     const char *producer_id,
+                                                     YdbResultDetails *rd) {
+  if (!cfg || !producer_id) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set producer id");
+  }
+  try {
+    cfg->settings.ProducerId(producer_id);
+    cfg->settings.MessageGroupId(producer_id);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+ydb_status_t ydb_topic_writer_config_set_codec(YdbTopicWriterConfig *cfg,
+                                               ydb_topic_codec_t codec,
+                                               YdbResultDetails *rd) {
+  if (!cfg) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set codec");
+  }
+  switch (codec) {
+  case YDB_TOPIC_CODEC_RAW:
+    cfg->settings.Codec(NYdb::NTopic::ECodec::RAW);
+    return YDB_OK;
+  case YDB_TOPIC_CODEC_GZIP:
+    cfg->settings.Codec(NYdb::NTopic::ECodec::GZIP);
+    return YDB_OK;
+  case YDB_TOPIC_CODEC_ZSTD:
+    cfg->settings.Codec(NYdb::NTopic::ECodec::ZSTD);
+    return YDB_OK;
+  default:
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "unsupported topic codec");
+  }
+}
+
+ydb_status_t ydb_topic_writer_config_set_inflight_limit(
+    YdbTopicWriterConfig *cfg, uint64_t max_bytes, uint32_t max_messages,
+    YdbResultDetails *rd) {
+  if (!cfg) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set inflight limit");
+  }
+  if (max_bytes) {
+    cfg->settings.MaxMemoryUsage(max_bytes);
+  }
+  if (max_messages) {
+    cfg->settings.MaxInflightCount(max_messages);
+  }
+  return YDB_OK;
+}
+
+ydb_status_t ydb_topic_writer_config_set_batching(YdbTopicWriterConfig *cfg,
+                                                  uint32_t linger_ms,
+                                                  uint64_t batch_bytes,
+                                                  YdbResultDetails *rd) {
+  if (!cfg) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set batching");
+  }
+  cfg->settings.BatchFlushInterval(TDuration::MilliSeconds(linger_ms));
+  if (batch_bytes) {
+    cfg->settings.BatchFlushSizeBytes(batch_bytes);
+  }
+  return YDB_OK;
+}
+
+ydb_status_t ydb_topic_writer_config_set_ack_callback(
+    YdbTopicWriterConfig *cfg, ydb_topic_ack_callback_t cb, void *user_data,
+    YdbResultDetails *rd) {
+  if (!cfg) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set ack callback");
+  }
+  cfg->on_ack = cb;
+  cfg->user_data = user_data;
+  return YDB_OK;
+}
+
+YdbTopicWriter *ydb_topic_writer_create(YdbTopicClient *tc,
+                                        const YdbTopicWriterConfig *cfg,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!tc || !tc->client || !cfg) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "topic client or writer config is null");
+      return nullptr;
+    }
+
+    auto writer = std::make_unique<YdbTopicWriter>();
+    writer->state = std::make_shared<YdbTopicWriterState>();
+    writer->state->on_ack = cfg->on_ack;
+    writer->state->user_data = cfg->user_data;
+
+    auto settings = cfg->settings;
+    settings.EventHandlers(writer_handlers(writer->state));
+    writer->session = tc->client->CreateWriteSession(settings);
+    return writer.release();
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+ydb_status_t ydb_topic_writer_write(YdbTopicWriter *w, const void *data,
+                                    size_t len, uint64_t seq_no,
+                                    YdbResultDetails *rd) {
+  try {
+    if (!w || !w->session || (!data && len != 0)) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid topic write arguments");
+    }
+
+    std::optional<NYdb::NTopic::TContinuationToken> token;
+    {
+      std::lock_guard lock(w->state->mutex);
+      if (w->state->closed.has_value()) {
+        return ydb_fill_from_status(rd, *w->state->closed);
+      }
+      if (w->state->tokens.empty()) {
+        // back pressure, not a failure: rd stays untouched
+        return YDB_ERR_WOULD_BLOCK;
+      }
+      token.emplace(std::move(w->state->tokens.front()));
+      w->state->tokens.pop_front();
+    }
+
+    NYdb::NTopic::TWriteMessage message(
+        std::string_view(static_cast<const char *>(data), len));
+    if (seq_no) {
+      message.SeqNo(seq_no);
+    }
+    w->session->Write(std::move(*token), std::move(message));
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_topic_writer_wait_ready(YdbTopicWriter *w,
+                                         uint32_t timeout_ms,
+                                         YdbResultDetails *rd) {
+  try {
+    if (!w || !w->state) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "topic writer is null");
+    }
+    std::unique_lock lock(w->state->mutex);
+    const bool woken = w->state->ready.wait_for(
+        lock, std::chrono::milliseconds(timeout_ms), [&] {
+          return w->state->closed.has_value() || !w->state->tokens.empty();
+        });
+    if (w->state->closed.has_value()) {
+      return ydb_fill_from_status(rd, *w->state->closed);
+    }
+    if (!woken) {
+      return ydb_result_details_fail(rd, YDB_ERR_TIMEOUT,
+                                     "topic writer did not become ready");
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_topic_writer_close(YdbTopicWriter *w, uint32_t timeout_ms,
+                                    YdbResultDetails *rd) {
+  try {
+    if (!w || !w->session) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "topic writer is null");
+    }
+    if (!w->session->Close(TDuration::MilliSeconds(timeout_ms))) {
+      return ydb_result_details_fail(rd, YDB_ERR_TIMEOUT,
+                                     "topic writer did not drain in time");
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_topic_writer_free(YdbTopicWriter *w) {
+  try {
+    if (w && w->session) {
+      w->session->Close(TDuration::Zero());
+    }
+    delete w;
+  } catch (...) {
+  }
+}
+
+/* ── Reader ──────────────────────────────────────────────────────── */
+
+YdbTopicReaderConfig *ydb_topic_reader_config_create(const char *topic_path,
+                                                     const char *consumer,
+                                                     YdbResultDetails *rd) {
+  try {
+    if (!topic_path || !consumer) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "topic path or consumer is null");
+      return nullptr;
+    }
+    auto *cfg = new (std::nothrow) YdbTopicReaderConfig();
+    if (!cfg) {
+      ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                              "failed to allocate topic reader config");
+      return nullptr;
+    }
+    cfg->settings.ConsumerName(consumer).AppendTopics(
+        NYdb::NTopic::TTopicReadSettings(topic_path));
+    return cfg;
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+void ydb_topic_reader_config_free(YdbTopicReaderConfig *cfg) { delete cfg; }
+
+ydb_status_t ydb_topic_reader_config_set_max_memory(YdbTopicReaderConfig *cfg,
+                                                    uint64_t max_bytes,
+                                                    YdbResultDetails *rd) {
+  if (!cfg || max_bytes == 0) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                   "failed to set reader memory limit");
+  }
+  cfg->settings.MaxMemoryUsageBytes(max_bytes);
+  return YDB_OK;
+}
+
+YdbTopicReader *ydb_topic_reader_create(YdbTopicClient *tc,
+                                        const YdbTopicReaderConfig *cfg,
+                                        YdbResultDetails *rd) {
+  try {
+    if (!tc || !tc->client || !cfg) {
+      ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                              "topic client or reader config is null");
+      return nullptr;
+    }
+    auto reader = std::make_unique<YdbTopicReader>();
+    reader->session = tc->client->CreateReadSession(cfg->settings);
+    return reader.release();
+  } catch (const std::exception &e) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+    return nullptr;
+  } catch (...) {
+    ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "uncaught C++ exception");
+    return nullptr;
+  }
+}
+
+ydb_status_t ydb_topic_reader_read_batch(YdbTopicReader *r,
+                                         uint32_t timeout_ms, size_t max_bytes,
+                                         YdbTopicBatch **out,
+                                         YdbResultDetails *rd) {
+  try {
+    if (!r || !r->session || !out) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "invalid topic read arguments");
+    }
+    *out = nullptr;
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms);
+    auto batch = std::make_unique<YdbTopicBatch>();
+    std::optional<NYdb::TStatus> closed;
+    for (;;) {
+      auto events = r->session->GetEvents(false, std::nullopt,
+                                          max_bytes ? max_bytes : SIZE_MAX);
+      for (auto &ev : events) {
+        handle_read_event(ev, *batch, closed);
+      }
+      if (!batch->events.empty()) {
+        break;
+      }
+      if (closed.has_value()) {
+        return ydb_fill_from_status(rd, *closed);
+      }
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        return ydb_result_details_fail(rd, YDB_ERR_TIMEOUT,
+                                       "no topic messages before timeout");
+      }
+      r->session->WaitEvent().Wait(TDuration::MicroSeconds(
+          std::chrono::duration_cast<std::chrono::microseconds>(deadline - now)
+              .count()));
+    }
+
+    for (auto &event : batch->events) {
+      for (const auto &message : event.GetMessages()) {
+        batch->messages.push_back(
+            {message.GetData().data(), message.GetData().size(),
+             message.GetOffset(), message.GetSeqNo(),
+             static_cast<int64_t>(
+                 message.GetPartitionSession()->GetPartitionId())});
+      }
+    }
+    *out = batch.release();
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_topic_reader_free(YdbTopicReader *r) {
+  try {
+    if (r && r->session) {
+      r->session->Close(TDuration::Zero());
+    }
+    delete r;
+  } catch (...) {
+  }
+}
+
+size_t ydb_topic_batch_size(const YdbTopicBatch *b) {
+  return b ? b->messages.size() : 0;
+}
+
+const YdbTopicMessage *ydb_topic_batch_messages(const YdbTopicBatch *b) {
+  return b && !b->messages.empty() ? b->messages.data() : nullptr;
+}
+
+ydb_status_t ydb_topic_batch_commit(YdbTopicBatch *b, YdbResultDetails *rd) {
+  try {
+    if (!b) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "topic batch is null");
+    }
+    for (auto &event : b->events) {
+      event.Commit();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+void ydb_topic_batch_free(YdbTopicBatch *b) { delete b; }
+
+} // extern "C"
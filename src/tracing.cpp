@@ -0,0 +1,121 @@
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+
+thread_local std::string trace_parent;
+
+} // namespace
+
+YdbSpan::YdbSpan(std::shared_ptr<const YdbTracer> t, const char *name,
+                 std::initializer_list<YdbSpanAttribute> attrs)
+    : tracer(std::move(t)) {
+  if (!tracer) {
+    return;
+  }
+  start = std::chrono::steady_clock::now();
+  handle = tracer->start(name, attrs.size() ? attrs.begin() : nullptr,
+                         attrs.size(), tracer->user_data);
+}
+
+ydb_status_t YdbSpan::end(ydb_status_t status) {
+  if (tracer) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    tracer->end(handle, status, static_cast<uint64_t>(elapsed.count()),
+                tracer->user_data);
+    tracer.reset();
+  }
+  return status;
+}
+
+YdbSpan ydb_query_span(const YdbDriver *drv, std::string_view yql) {
+  auto tracer = ydb_driver_tracer(drv);
+  const uint32_t limit =
+      drv ? drv->trace_query_text_bytes.load(std::memory_order_relaxed) : 0;
+  if (!tracer || limit == 0) {
+    return YdbSpan(std::move(tracer), "ydb.ExecuteQuery",
+                   {{"db.system", "ydb"}});
+  }
+  size_t n = std::min<size_t>(yql.size(), limit);
+  // never split a UTF-8 sequence
+  while (n < yql.size() && n > 0 &&
+         (static_cast<unsigned char>(yql[n]) & 0xC0) == 0x80) {
+    --n;
+  }
+  const std::string text(yql.substr(0, n));
+  return YdbSpan(std::move(tracer), "ydb.ExecuteQuery",
+                 {{"db.system", "ydb"}, {"db.query.text", text.c_str()}});
+}
+
+const std::string &ydb_trace_parent() { return trace_parent; }
+
+std::shared_ptr<const YdbTracer> ydb_driver_tracer(const YdbDriver *drv) {
+  return drv ? drv->tracer.load(std::memory_order_acquire) : nullptr;
+}
+
+extern "C" {
+
+ydb_status_t ydb_driver_set_tracer(YdbDriver *drv,
+                                   ydb_span_start_callback_t start,
+                                   ydb_span_end_callback_t end,
+                                   void *user_data, YdbResultDetails *rd) {
+  try {
+    if (!drv) {
+      return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST,
+                                     "driver is null");
+    }
+    if (!start != !end) {
+      return ydb_result_details_fail(
+          rd, YDB_ERR_BAD_REQUEST,
+          "span start and end callbacks must be set together");
+    }
+    std::shared_ptr<const YdbTracer> tracer;
+    if (start) {
+      tracer = std::make_shared<const YdbTracer>(
+          YdbTracer{start, end, user_data});
+    }
+    // spans already open keep the old tracer until they end
+    drv->tracer.store(std::move(tracer), std::memory_order_release);
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  } catch (...) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL,
+                                   "uncaught C++ exception");
+  }
+}
+
+ydb_status_t ydb_driver_set_trace_query_text(YdbDriver *drv,
+                                            uint32_t max_bytes,
+                                            YdbResultDetails *rd) {
+  if (!drv) {
+    return ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "driver is null");
+  }
+  drv->trace_query_text_bytes.store(max_bytes, std::memory_order_relaxed);
+  return YDB_OK;
+}
+
+ydb_status_t ydb_trace_set_parent(const char *traceparent,
+                                  YdbResultDetails *rd) {
+  try {
+    if (traceparent) {
+      trace_parent = traceparent;
+    } else {
+      trace_parent.clear();
+    }
+    return YDB_OK;
+  } catch (const std::exception &e) {
+    return ydb_result_details_fail(rd, YDB_ERR_INTERNAL, e.what());
+  }
+}
+
+} // extern "C"
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "test_helpers.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+TEST(Arena, BoundArenaOwnsParamBuilders) {
+  YdbArena *arena = ydb_arena_create(0, nullptr);
+  ASSERT_NE(arena, nullptr);
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  EXPECT_EQ(ydb_arena_bind(arena), nullptr);
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$ids", nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(b->arena, arena);
+  ASSERT_EQ(ydb_params_begin_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_add_list_item_int64(b, 1, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+  EXPECT_EQ(arena->cleanups.size(), 1u);
+  EXPECT_EQ(ydb_arena_bind(nullptr), arena);
+
+  // the value itself is owned by the params, not the arena
+  ydb_arena_reset(arena);
+  EXPECT_TRUE(arena->cleanups.empty());
+  EXPECT_TRUE(ydb_query_params_get(p).GetValue("$ids").has_value());
+
+  ydb_query_params_free(p, nullptr);
+  ydb_arena_free(arena);
+}
+
+TEST(Arena, UnboundAllocationsUseTheHeap) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$id", nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(b->arena, nullptr);
+  ASSERT_EQ(ydb_params_begin_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_add_list_item_int64(b, 1, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+  ydb_query_params_free(p, nullptr);
+}
+
+// the container's deleters run during reset; under YDB_C_SANITIZE_ADDRESS
+// destroyed arena objects are poisoned, so touching a child twice fails
+TEST(Arena, ResetDestroysMultiSetResult) {
+  YdbArena *arena = ydb_arena_create(0, nullptr);
+  ASSERT_NE(arena, nullptr);
+
+  ydb_arena_bind(arena);
+  YdbResultSets *sets = ydb_arena_new<YdbResultSets>();
+  for (int rows : {1, 2, 3}) {
+    sets->sets.emplace_back(
+        ydb_arena_new<YdbResultSet>(MakeIdSet(rows, Ydb::Type::INT64)));
+  }
+  ydb_arena_bind(nullptr);
+  EXPECT_EQ(sets->arena, arena);
+  EXPECT_EQ(arena->cleanups.size(), 4u);
+
+  ydb_arena_reset(arena);
+  EXPECT_TRUE(arena->cleanups.empty());
+
+  // the reset arena is usable again
+  ydb_arena_bind(arena);
+  YdbResultSets *again = ydb_arena_new<YdbResultSets>();
+  again->sets.emplace_back(
+      ydb_arena_new<YdbResultSet>(MakeIdSet(1, Ydb::Type::INT64)));
+  ydb_arena_bind(nullptr);
+  ydb_arena_free(arena);
+}
@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "test_helpers.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Exercises the model documented under "Thread Safety" in ydb.h. Meant to be
+// run from a YDB_C_SANITIZE_THREAD=ON build, where a data race fails the
+// test even when the assertions pass.
+
+namespace {
+constexpr int kThreads = 16;
+
+template <typename F> void RunThreads(int n, F body) {
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n; ++t) {
+    threads.emplace_back([&, t] {
+      while (!go.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      body(t);
+    });
+  }
+  go.store(true, std::memory_order_release);
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+struct SpanCounts {
+  std::atomic<int> started{0};
+  std::atomic<int> ended{0};
+};
+
+void *CountStart(const char *, const YdbSpanAttribute *, size_t,
+                 void *user_data) {
+  static_cast<SpanCounts *>(user_data)->started.fetch_add(1);
+  return nullptr;
+}
+
+void CountEnd(void *, ydb_status_t, uint64_t, void *user_data) {
+  static_cast<SpanCounts *>(user_data)->ended.fetch_add(1);
+}
+} // namespace
+
+TEST(ConcurrencyStress, PreparedQueriesAreSharedPerText) {
+  YdbQueryClient qc;
+  constexpr int kTexts = 8;
+  std::vector<std::vector<YdbPreparedQuery *>> seen(
+      kThreads, std::vector<YdbPreparedQuery *>(kTexts));
+
+  RunThreads(kThreads, [&](int t) {
+    for (int round = 0; round < 500; ++round) {
+      for (int i = 0; i < kTexts; ++i) {
+        const std::string yql = "SELECT " + std::to_string(i) + ";";
+        YdbPreparedQuery *pq = nullptr;
+        ASSERT_EQ(ydb_query_prepare(&qc, yql.c_str(), &pq, nullptr), YDB_OK);
+        ASSERT_EQ(pq->text, yql);
+        seen[t][i] = pq;
+      }
+    }
+  });
+
+  EXPECT_EQ(qc.prepared.size(), static_cast<size_t>(kTexts));
+  for (int t = 1; t < kThreads; ++t) {
+    EXPECT_EQ(seen[t], seen[0]);
+  }
+}
+
+TEST(ConcurrencyStress, ExecSettingsSwapIsAtomic) {
+  YdbQueryClient qc;
+  YdbExecSettings *fast = ydb_exec_settings_create(nullptr);
+  YdbExecSettings *slow = ydb_exec_settings_create(nullptr);
+  ASSERT_NE(fast, nullptr);
+  ASSERT_NE(slow, nullptr);
+  ASSERT_EQ(ydb_exec_settings_set_client_timeout(fast, 10, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_exec_settings_set_resource_pool(fast, "fast", nullptr),
+            YDB_OK);
+  ASSERT_EQ(ydb_exec_settings_set_client_timeout(slow, 1000, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_exec_settings_set_resource_pool(slow, "slow", nullptr),
+            YDB_OK);
+
+  std::atomic<bool> done{false};
+  RunThreads(kThreads, [&](int t) {
+    if (t == 0) {
+      for (int i = 0; i < 5000; ++i) {
+        ydb_query_client_set_exec_settings(&qc, i % 2 ? fast : slow, nullptr);
+      }
+      done.store(true);
+      return;
+    }
+    while (!done.load()) {
+      const auto exec = qc.exec.load(std::memory_order_acquire);
+      if (!exec) {
+        continue;
+      }
+      // a torn read would pair one pool with the other's timeout
+      ASSERT_EQ(*exec->resource_pool,
+                exec->client_timeout_ms == 10 ? "fast" : "slow");
+    }
+  });
+
+  ydb_exec_settings_free(fast);
+  ydb_exec_settings_free(slow);
+}
+
+TEST(ConcurrencyStress, TracerSwapKeepsOpenSpansBalanced) {
+  YdbDriver drv;
+  SpanCounts counts;
+  std::atomic<bool> done{false};
+
+  RunThreads(kThreads, [&](int t) {
+    if (t == 0) {
+      for (int i = 0; i < 2000; ++i) {
+        if (i % 2) {
+          ydb_driver_set_tracer(&drv, CountStart, CountEnd, &counts, nullptr);
+        } else {
+          ydb_driver_set_tracer(&drv, nullptr, nullptr, nullptr, nullptr);
+        }
+      }
+      done.store(true);
+      return;
+    }
+    while (!done.load()) {
+      YdbSpan span(ydb_driver_tracer(&drv), "op", {{"db.system", "ydb"}});
+      span.end(YDB_OK);
+    }
+  });
+
+  EXPECT_EQ(counts.started.load(), counts.ended.load());
+}
+
+void CountLog(ydb_log_level_t, ydb_status_t, const char *, void *user_data) {
+  static_cast<std::atomic<int> *>(user_data)->fetch_add(1);
+}
+
+// the counter is deleted right after free, so a log call still running on
+// a freed logger shows up as a heap use-after-free
+TEST(ConcurrencyStress, LoggerReconfigureAndFreeWhileLogging) {
+  std::atomic<bool> done{false};
+
+  RunThreads(kThreads, [&](int t) {
+    if (t == 0) {
+      for (int i = 0; i < 500; ++i) {
+        auto *count = new std::atomic<int>(0);
+        YdbErrorLogger *logger =
+            ydb_error_logger_create(YDB_LOG_DEBUG, nullptr);
+        ASSERT_NE(logger, nullptr);
+        ydb_error_logger_set_ring_buffer(logger, 8, nullptr);
+        ydb_error_logger_install(logger);
+        ydb_error_logger_set_callback(logger, CountLog, count, nullptr);
+        ydb_error_logger_set_rate_limit(logger, i % 2 ? 0 : 1000, nullptr);
+        ydb_error_logger_set_callback(logger, nullptr, nullptr, nullptr);
+        ydb_error_logger_set_callback(logger, CountLog, count, nullptr);
+        ydb_error_logger_free(logger);
+        delete count;
+      }
+      done.store(true);
+      return;
+    }
+    while (!done.load()) {
+      ydb_log(YDB_LOG_ERROR, YDB_ERR_TIMEOUT, "stress");
+    }
+  });
+}
+
+TEST(ConcurrencyStress, ThreadLocalDetailsDoNotMix) {
+  RunThreads(kThreads, [](int t) {
+    YdbResultDetails *rd = ydb_result_details_thread_local();
+    const std::string msg = "thread " + std::to_string(t);
+    const ydb_status_t code = t % 2 ? YDB_ERR_TIMEOUT : YDB_ERR_NOT_FOUND;
+    for (int i = 0; i < 2000; ++i) {
+      ydb_result_details_reset(rd);
+      ydb_result_details_fail(rd, code, msg.c_str());
+      ASSERT_EQ(ydb_result_details_code(rd), code);
+      ASSERT_NE(std::string(get_message(rd)).find(msg), std::string::npos);
+    }
+  });
+}
+
+TEST(ConcurrencyStress, ConfinedHandlesOnManyThreads) {
+  ydb_metrics_set_enabled(1);
+  ydb_metrics_reset();
+  std::atomic<bool> done{false};
+  std::thread snapshots([&] {
+    while (!done.load()) {
+      ydb_metrics_snapshot_free(ydb_metrics_snapshot(nullptr));
+    }
+  });
+
+  RunThreads(kThreads, [](int t) {
+    YdbQueryParams *p = ydb_query_params_create(nullptr);
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i < 200; ++i) {
+      ASSERT_EQ(ydb_params_set_int64(p, "$id", t * 1000 + i, nullptr), YDB_OK);
+      YdbParamBuilder *b = ydb_params_begin_param(p, "$ids", nullptr);
+      ASSERT_NE(b, nullptr);
+      ASSERT_EQ(ydb_params_begin_list(b, nullptr), YDB_OK);
+      ASSERT_EQ(ydb_params_add_list_item_int64(b, i, nullptr), YDB_OK);
+      ASSERT_EQ(ydb_params_end_list(b, nullptr), YDB_OK);
+      ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+      YdbResultSet *rs = MakeIdResultSet(16, Ydb::Type::INT64);
+      int64_t sum = 0;
+      while (ydb_resultset_next_row(rs, nullptr)) {
+        int64_t v = 0;
+        ASSERT_EQ(ydb_resultset_get_int64(rs, 0, &v, nullptr), YDB_OK);
+        sum += v;
+      }
+      ASSERT_EQ(sum, 120);
+      ydb_resultset_free(rs);
+      ydb_metrics_record(YDB_METRIC_EXECUTE, std::chrono::microseconds(i));
+    }
+    ydb_query_params_free(p, nullptr);
+  });
+
+  done.store(true);
+  snapshots.join();
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  YdbLatencySummary summary{};
+  ASSERT_EQ(ydb_metrics_snapshot_latency(s, YDB_METRIC_EXECUTE, &summary,
+                                         nullptr),
+            YDB_OK);
+  EXPECT_EQ(summary.count, static_cast<uint64_t>(kThreads) * 200);
+  ydb_metrics_snapshot_free(s);
+  ydb_metrics_reset();
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+struct Captured {
+  std::vector<ydb_status_t> codes;
+  std::vector<std::string> messages;
+};
+
+void Capture(ydb_log_level_t, ydb_status_t code, const char *message,
+             void *user_data) {
+  auto *captured = static_cast<Captured *>(user_data);
+  captured->codes.push_back(code);
+  captured->messages.emplace_back(message);
+}
+} // namespace
+
+TEST(ErrorLogger, CallbackReceivesFailuresAtOrAboveLevel) {
+  Captured captured;
+  YdbErrorLogger *logger = ydb_error_logger_create(YDB_LOG_ERROR, nullptr);
+  ASSERT_NE(logger, nullptr);
+  ASSERT_EQ(ydb_error_logger_set_callback(logger, Capture, &captured, nullptr),
+            YDB_OK);
+  ydb_error_logger_install(logger);
+
+  ydb_result_details_fail(nullptr, YDB_ERR_BAD_REQUEST, "bad input");
+  ydb_log(YDB_LOG_WARN, YDB_ERR_CONNECTION, "below level");
+
+  ydb_error_logger_free(logger);
+  ydb_result_details_fail(nullptr, YDB_ERR_INTERNAL, "after uninstall");
+
+  ASSERT_EQ(captured.codes.size(), 1u);
+  EXPECT_EQ(captured.codes[0], YDB_ERR_BAD_REQUEST);
+  EXPECT_EQ(captured.messages[0], "bad input");
+}
+
+TEST(ErrorLogger, RingBufferKeepsNewestRecords) {
+  YdbErrorLogger *logger = ydb_error_logger_create(YDB_LOG_DEBUG, nullptr);
+  ASSERT_NE(logger, nullptr);
+  ASSERT_EQ(ydb_error_logger_set_ring_buffer(logger, 2, nullptr), YDB_OK);
+  ydb_error_logger_install(logger);
+
+  ydb_log(YDB_LOG_ERROR, -1, "first");
+  ydb_log(YDB_LOG_ERROR, -2, "second");
+  ydb_log(YDB_LOG_ERROR, -3, "third");
+
+  Captured captured;
+  EXPECT_EQ(ydb_error_logger_drain(logger, Capture, &captured), 2u);
+  EXPECT_EQ(captured.messages, (std::vector<std::string>{"second", "third"}));
+  EXPECT_EQ(ydb_error_logger_dropped(logger), 1u);
+  EXPECT_EQ(ydb_error_logger_drain(logger, Capture, &captured), 0u);
+
+  ydb_error_logger_free(logger);
+}
+
+TEST(ErrorLogger, RateLimitDropsExcessRecords) {
+  Captured captured;
+  YdbErrorLogger *logger = ydb_error_logger_create(YDB_LOG_DEBUG, nullptr);
+  ASSERT_NE(logger, nullptr);
+  ASSERT_EQ(ydb_error_logger_set_callback(logger, Capture, &captured, nullptr),
+            YDB_OK);
+  ASSERT_EQ(ydb_error_logger_set_rate_limit(logger, 3, nullptr), YDB_OK);
+  ydb_error_logger_install(logger);
+
+  for (int i = 0; i < 10; ++i) {
+    ydb_log(YDB_LOG_ERROR, -1, "storm");
+  }
+
+  // the test could straddle a second boundary and get one more window
+  EXPECT_GE(captured.codes.size(), 3u);
+  EXPECT_LE(captured.codes.size(), 6u);
+  EXPECT_EQ(ydb_error_logger_dropped(logger), 10u - captured.codes.size());
+
+  ydb_error_logger_free(logger);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+class Metrics : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ydb_metrics_set_enabled(1);
+    ydb_metrics_reset();
+  }
+  void TearDown() override { ydb_metrics_reset(); }
+};
+} // namespace
+
+TEST(MetricsBuckets, UpperBoundsCoverEveryValue) {
+  for (uint64_t us = 0; us < 100000; ++us) {
+    const size_t bucket = ydb_metrics_bucket(us);
+    ASSERT_LE(us, ydb_metrics_bucket_upper(bucket)) << us;
+    if (bucket > 0) {
+      ASSERT_GT(us, ydb_metrics_bucket_upper(bucket - 1)) << us;
+    }
+  }
+  EXPECT_EQ(ydb_metrics_bucket(UINT64_MAX), YdbMetricsLayout::kBuckets - 1);
+}
+
+TEST(MetricsBuckets, RelativeErrorWithinQuarter) {
+  for (uint64_t us = 4; us < (uint64_t{1} << 30); us = us * 3 / 2 + 1) {
+    const uint64_t upper = ydb_metrics_bucket_upper(ydb_metrics_bucket(us));
+    EXPECT_LE(upper - us, us / 4) << us;
+  }
+}
+
+TEST_F(Metrics, LatencySummaryReflectsSamples) {
+  for (int i = 0; i < 99; ++i) {
+    ydb_metrics_record(YDB_METRIC_EXECUTE, std::chrono::microseconds(100));
+  }
+  ydb_metrics_record(YDB_METRIC_EXECUTE, std::chrono::milliseconds(50));
+
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  YdbLatencySummary summary{};
+  ASSERT_EQ(ydb_metrics_snapshot_latency(s, YDB_METRIC_EXECUTE, &summary,
+                                         nullptr),
+            YDB_OK);
+  EXPECT_EQ(summary.count, 100u);
+  EXPECT_EQ(summary.sum_us, 99u * 100u + 50000u);
+  EXPECT_GE(summary.p50_us, 100u);
+  EXPECT_LE(summary.p50_us, 125u);
+  EXPECT_GE(summary.p99_us, 100u);
+  EXPECT_LE(summary.p99_us, 125u);
+  EXPECT_EQ(summary.max_us, 50000u);
+
+  ASSERT_EQ(ydb_metrics_snapshot_latency(s, YDB_METRIC_COMMIT, &summary,
+                                         nullptr),
+            YDB_OK);
+  EXPECT_EQ(summary.count, 0u);
+  ydb_metrics_snapshot_free(s);
+}
+
+TEST_F(Metrics, ShardsAreMergedAcrossThreads) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([] {
+      for (int i = 0; i < 1000; ++i) {
+        ydb_metrics_add(YDB_METRIC_ROWS_RETURNED, 2);
+        ydb_metrics_record(YDB_METRIC_GET_SESSION,
+                           std::chrono::microseconds(i));
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  EXPECT_EQ(ydb_metrics_snapshot_counter(s, YDB_METRIC_ROWS_RETURNED), 16000u);
+  YdbLatencySummary summary{};
+  ASSERT_EQ(ydb_metrics_snapshot_latency(s, YDB_METRIC_GET_SESSION, &summary,
+                                         nullptr),
+            YDB_OK);
+  EXPECT_EQ(summary.count, 8000u);
+  ydb_metrics_snapshot_free(s);
+}
+
+TEST_F(Metrics, StatusDistributionCountsMappedCodes) {
+  ydb_fill_from_status(nullptr, NYdb::TStatus(NYdb::EStatus::SUCCESS, {}));
+  ydb_fill_from_status(nullptr, NYdb::TStatus(NYdb::EStatus::OVERLOADED, {}));
+  ydb_fill_from_status(nullptr, NYdb::TStatus(NYdb::EStatus::UNAVAILABLE, {}));
+
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  EXPECT_EQ(ydb_metrics_snapshot_status_count(s, YDB_OK), 1u);
+  EXPECT_EQ(ydb_metrics_snapshot_status_count(s, YDB_ERR_CONNECTION), 2u);
+  EXPECT_EQ(ydb_metrics_snapshot_status_count(s, YDB_ERR_TIMEOUT), 0u);
+  ydb_metrics_snapshot_free(s);
+}
+
+TEST_F(Metrics, DisabledRecordsNothing) {
+  ydb_metrics_set_enabled(0);
+  ydb_metrics_add(YDB_METRIC_RETRY_ATTEMPTS, 5);
+  ydb_metrics_count_status(YDB_ERR_INTERNAL);
+  ydb_metrics_set_enabled(1);
+
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  EXPECT_EQ(ydb_metrics_snapshot_counter(s, YDB_METRIC_RETRY_ATTEMPTS), 0u);
+  EXPECT_EQ(ydb_metrics_snapshot_status_count(s, YDB_ERR_INTERNAL), 0u);
+  ydb_metrics_snapshot_free(s);
+}
+
+TEST_F(Metrics, PrometheusTextHasCumulativeBuckets) {
+  ydb_metrics_record(YDB_METRIC_COMMIT, std::chrono::microseconds(3));
+  ydb_metrics_record(YDB_METRIC_COMMIT, std::chrono::microseconds(1000));
+  ydb_metrics_add(YDB_METRIC_BYTES_RETURNED, 42);
+  ydb_metrics_count_status(YDB_ERR_TIMEOUT);
+
+  YdbMetricsSnapshot *s = ydb_metrics_snapshot(nullptr);
+  ASSERT_NE(s, nullptr);
+  const char *text = ydb_metrics_snapshot_prometheus(s, nullptr);
+  ASSERT_NE(text, nullptr);
+  const std::string out(text);
+
+  EXPECT_NE(out.find("# TYPE ydb_c_operation_duration_seconds histogram"),
+            std::string::npos);
+  EXPECT_NE(out.find("ydb_c_operation_duration_seconds_bucket{op=\"commit\","
+                     "le=\"3e-06\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("ydb_c_operation_duration_seconds_bucket{op=\"commit\","
+                     "le=\"+Inf\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("ydb_c_operation_duration_seconds_count{op=\"commit\"} "
+                     "2\n"),
+            std::string::npos);
+  EXPECT_NE(out.find("ydb_c_result_bytes_total 42\n"), std::string::npos);
+  EXPECT_NE(out.find("ydb_c_status_total{code=\"-3\"} 1\n"),
+            std::string::npos);
+  ydb_metrics_snapshot_free(s);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <ydb-cpp-sdk/client/value/value.h>
+
+namespace {
+int64_t Int64Param(const YdbQueryParams *p, const std::string &name) {
+  auto value = ydb_query_params_get(p).GetValue(name);
+  EXPECT_TRUE(value.has_value());
+  return NYdb::TValueParser(*value).GetInt64();
+}
+} // namespace
+
+TEST(QueryParams, SetOverwritesExistingValue) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 1, nullptr), YDB_OK);
+  EXPECT_EQ(Int64Param(p, "$id"), 1);
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 2, nullptr), YDB_OK);
+  EXPECT_EQ(Int64Param(p, "$id"), 2);
+  EXPECT_EQ(ydb_query_params_get(p).GetValues().size(), 1u);
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, BuildDoesNotConsumeParams) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 7, nullptr), YDB_OK);
+  EXPECT_EQ(Int64Param(p, "$id"), 7);
+  EXPECT_EQ(Int64Param(p, "$id"), 7);
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, ResetKeepsNamesAndDropsValues) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 1, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_set_utf8(p, "$name", "a", nullptr), YDB_OK);
+  ASSERT_EQ(ydb_query_params_reset(p, nullptr), YDB_OK);
+
+  EXPECT_EQ(p->values.size(), 2u);
+  EXPECT_TRUE(ydb_query_params_get(p).Empty());
+
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 3, nullptr), YDB_OK);
+  EXPECT_EQ(Int64Param(p, "$id"), 3);
+  EXPECT_FALSE(ydb_query_params_get(p).GetValue("$name").has_value());
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, ListBuilderStoresValueOnEnd) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$ids", nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_EQ(ydb_params_begin_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_add_list_item_int64(b, 10, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_add_list_item_int64(b, 20, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_list(b, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+  auto value = ydb_query_params_get(p).GetValue("$ids");
+  ASSERT_TRUE(value.has_value());
+  NYdb::TValueParser parser(*value);
+  parser.OpenList();
+  std::vector<int64_t> items;
+  while (parser.TryNextListItem()) {
+    items.push_back(parser.GetInt64());
+  }
+  parser.CloseList();
+  EXPECT_EQ(items, (std::vector<int64_t>{10, 20}));
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, StructListFromColumns) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  const int64_t ids[] = {1, 2, 3};
+  const char names[] = "abbccc";
+  const uint32_t offsets[] = {0, 1, 3, 6};
+  const uint8_t validity[] = {0x5}; // row 1 is NULL
+  const YdbColumnBinding cols[] = {
+      {"id", YDB_TYPE_INT64, ids, nullptr, nullptr},
+      {"name", YDB_TYPE_UTF8, names, offsets, validity},
+  };
+
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$rows", nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_EQ(ydb_params_bind_struct_list(b, 3, 2, cols, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+  auto value = ydb_query_params_get(p).GetValue("$rows");
+  ASSERT_TRUE(value.has_value());
+  NYdb::TValueParser parser(*value);
+  std::vector<int64_t> got_ids;
+  std::vector<std::optional<std::string>> got_names;
+  parser.OpenList();
+  while (parser.TryNextListItem()) {
+    parser.OpenStruct();
+    ASSERT_TRUE(parser.TryNextMember());
+    got_ids.push_back(parser.GetInt64());
+    ASSERT_TRUE(parser.TryNextMember());
+    got_names.push_back(parser.GetOptionalUtf8());
+    parser.CloseStruct();
+  }
+  parser.CloseList();
+
+  EXPECT_EQ(got_ids, (std::vector<int64_t>{1, 2, 3}));
+  EXPECT_EQ(got_names, (std::vector<std::optional<std::string>>{
+                           "a", std::nullopt, "ccc"}));
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, StructListRejectsMissingOffsetsAndAllowsEmpty) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  const char data[] = "x";
+  const YdbColumnBinding col = {"s", YDB_TYPE_UTF8, data, nullptr, nullptr};
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$rows", nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(ydb_params_bind_struct_list(b, 1, 1, &col, nullptr),
+            YDB_ERR_BAD_REQUEST);
+  ASSERT_EQ(ydb_params_bind_struct_list(b, 0, 1, &col, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+  auto value = ydb_query_params_get(p).GetValue("$rows");
+  ASSERT_TRUE(value.has_value());
+  NYdb::TValueParser parser(*value);
+  parser.OpenList();
+  EXPECT_FALSE(parser.TryNextListItem());
+  parser.CloseList();
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, StructListFailureLeavesBuilderUsable) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  const int64_t ids[] = {1, 2};
+  const char names[] = "abc";
+  const uint32_t bad_offsets[] = {0, 2, 1};
+  const uint32_t offsets[] = {0, 1, 3};
+  YdbColumnBinding cols[] = {
+      {"id", YDB_TYPE_INT64, ids, nullptr, nullptr},
+      {"name", YDB_TYPE_UTF8, names, bad_offsets, nullptr},
+  };
+
+  YdbParamBuilder *b = ydb_params_begin_param(p, "$rows", nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(ydb_params_bind_struct_list(b, 2, 2, cols, nullptr),
+            YDB_ERR_BAD_REQUEST);
+  cols[1].name = "id";
+  cols[1].offsets = offsets;
+  EXPECT_EQ(ydb_params_bind_struct_list(b, 2, 2, cols, nullptr),
+            YDB_ERR_BAD_REQUEST);
+  cols[1].name = "name";
+  ASSERT_EQ(ydb_params_bind_struct_list(b, 2, 2, cols, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_params_end_param(b, nullptr), YDB_OK);
+
+  auto value = ydb_query_params_get(p).GetValue("$rows");
+  ASSERT_TRUE(value.has_value());
+  NYdb::TValueParser parser(*value);
+  std::vector<std::string> got;
+  parser.OpenList();
+  while (parser.TryNextListItem()) {
+    parser.OpenStruct();
+    ASSERT_TRUE(parser.TryNextMember());
+    ASSERT_TRUE(parser.TryNextMember());
+    got.push_back(parser.GetUtf8());
+    parser.CloseStruct();
+  }
+  parser.CloseList();
+  EXPECT_EQ(got, (std::vector<std::string>{"a", "bc"}));
+
+  ydb_query_params_free(p, nullptr);
+}
+
+TEST(QueryParams, FindBorrowsValueAndSkipsUnsetSlots) {
+  YdbQueryParams *p = ydb_query_params_create(nullptr);
+  ASSERT_NE(p, nullptr);
+
+  EXPECT_EQ(ydb_query_params_find(p, "$id"), nullptr);
+  ASSERT_EQ(ydb_params_set_int64(p, "$id", 5, nullptr), YDB_OK);
+  const NYdb::TValue *value = ydb_query_params_find(p, "$id");
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(NYdb::TValueParser(*value).GetInt64(), 5);
+  EXPECT_EQ(Int64Param(p, "$id"), 5);
+
+  ASSERT_EQ(ydb_query_params_reset(p, nullptr), YDB_OK);
+  EXPECT_EQ(ydb_query_params_find(p, "$id"), nullptr);
+
+  ydb_query_params_free(p, nullptr);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+TEST(PreparedQuery, CacheIsBoundedUntilUnprepared) {
+  YdbQueryClient qc;
+  ASSERT_EQ(ydb_query_client_set_prepared_limit(&qc, 2, nullptr), YDB_OK);
+
+  YdbPreparedQuery *a = nullptr;
+  YdbPreparedQuery *b = nullptr;
+  YdbPreparedQuery *c = nullptr;
+  ASSERT_EQ(ydb_query_prepare(&qc, "SELECT 1;", &a, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_query_prepare(&qc, "SELECT 2;", &b, nullptr), YDB_OK);
+  EXPECT_EQ(ydb_query_prepare(&qc, "SELECT 3;", &c, nullptr),
+            YDB_ERR_RESOURCE_EXHAUSTED);
+  YdbPreparedQuery *again = nullptr;
+  ASSERT_EQ(ydb_query_prepare(&qc, "SELECT 1;", &again, nullptr), YDB_OK);
+  EXPECT_EQ(again, a);
+
+  ASSERT_EQ(ydb_query_unprepare(&qc, a, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_query_prepare(&qc, "SELECT 3;", &c, nullptr), YDB_OK);
+  EXPECT_EQ(qc.prepared.size(), 2u);
+}
+
+TEST(PreparedQuery, HandleIsRejectedByAnotherClient) {
+  YdbQueryClient owner;
+  YdbQueryClient other;
+  YdbPreparedQuery *pq = nullptr;
+  ASSERT_EQ(ydb_query_prepare(&owner, "SELECT 1;", &pq, nullptr), YDB_OK);
+
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  EXPECT_EQ(ydb_query_execute_prepared(&other, pq, nullptr, nullptr, rd),
+            YDB_ERR_BAD_REQUEST);
+  ydb_result_details_reset(rd);
+  EXPECT_EQ(ydb_query_unprepare(&other, pq, rd), YDB_ERR_NOT_FOUND);
+  ydb_result_details_free(rd);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <string>
+
+TEST(ResultDetails, MessageIsFormattedOnDemand) {
+  YdbResultDetails *rd = nullptr;
+  ASSERT_EQ(ydb_result_details_init(&rd), 0);
+  ASSERT_NE(rd, nullptr);
+
+  ydb_result_details_fail(rd, YDB_ERR_BAD_REQUEST, "bad input");
+  EXPECT_FALSE(rd->message_ready);
+  EXPECT_EQ(ydb_result_details_code(rd), YDB_ERR_BAD_REQUEST);
+
+  // refused calls add their names to the trail
+  EXPECT_EQ(ydb_params_set_int64(nullptr, "$id", 1, rd), YDB_ERR_BAD_REQUEST);
+  EXPECT_EQ(rd->trail_size, 1u);
+  EXPECT_EQ(std::string(get_message(rd)), "bad input from ydb_params_set_int64");
+  EXPECT_TRUE(rd->message_ready);
+
+  ydb_result_details_free(rd);
+}
+
+TEST(ResultDetails, CodesOnlyKeepsNoText) {
+  YdbResultDetails *rd = ydb_result_details_create(1);
+  ASSERT_NE(rd, nullptr);
+
+  ydb_result_details_fail(rd, YDB_ERR_INTERNAL, "boom");
+  EXPECT_EQ(ydb_result_details_code(rd), YDB_ERR_INTERNAL);
+  EXPECT_STREQ(get_message(rd), "");
+
+  ydb_result_details_free(rd);
+}
+
+TEST(ResultDetails, ResetAllowsReuse) {
+  YdbResultDetails *rd = ydb_result_details_thread_local();
+  ASSERT_NE(rd, nullptr);
+  EXPECT_EQ(rd, ydb_result_details_thread_local());
+
+  ydb_result_details_fail(rd, YDB_ERR_TIMEOUT, "slow");
+  ydb_result_details_reset(rd);
+  EXPECT_EQ(ydb_result_details_code(rd), YDB_OK);
+  EXPECT_STREQ(get_message(rd), "");
+
+  YdbQueryParams *p = ydb_query_params_create(rd);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(ydb_params_set_int64(p, "$id", 1, rd), YDB_OK);
+  ydb_query_params_free(p, rd);
+
+  // the thread's object is owned by the library
+  ydb_result_details_free(rd);
+  EXPECT_EQ(rd, ydb_result_details_thread_local());
+}
+
+TEST(ResultDetails, LongTextIsTruncated) {
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  ASSERT_NE(rd, nullptr);
+
+  const std::string text(500, 'x');
+  ydb_result_details_fail(rd, YDB_ERR_GENERIC, text.c_str());
+  EXPECT_EQ(std::string(get_message(rd)).size(),
+            YdbResultDetails::kTextSize - 1);
+
+  ydb_result_details_free(rd);
+}
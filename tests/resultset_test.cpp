@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <src/api/protos/ydb_value.pb.h>
+
+#include <string>
+
+namespace {
+// columns: id Utf8, name Optional<Utf8>
+YdbResultSet *MakeStringResultSet() {
+  Ydb::ResultSet proto;
+  auto *id = proto.add_columns();
+  id->set_name("id");
+  id->mutable_type()->set_type_id(Ydb::Type::UTF8);
+  auto *name = proto.add_columns();
+  name->set_name("name");
+  name->mutable_type()->mutable_optional_type()->mutable_item()->set_type_id(
+      Ydb::Type::UTF8);
+
+  auto *row = proto.add_rows();
+  row->add_items()->set_text_value("k1");
+  row->add_items()->set_text_value("alice");
+  row = proto.add_rows();
+  row->add_items()->set_text_value("k2");
+  row->add_items()->set_null_flag_value(google::protobuf::NULL_VALUE);
+
+  return new YdbResultSet(NYdb::TResultSet(std::move(proto)));
+}
+} // namespace
+
+TEST(ResultSet, StringViewsSurviveOtherGetters) {
+  YdbResultSet *rs = MakeStringResultSet();
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+
+  const char *id = nullptr;
+  const char *name = nullptr;
+  size_t id_len = 0;
+  size_t name_len = 0;
+  ASSERT_EQ(ydb_resultset_get_utf8(rs, 0, &id, &id_len, nullptr), YDB_OK);
+  ASSERT_EQ(ydb_resultset_get_utf8(rs, 1, &name, &name_len, nullptr), YDB_OK);
+  EXPECT_EQ(std::string(id, id_len), "k1");
+  EXPECT_EQ(std::string(name, name_len), "alice");
+
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+  EXPECT_EQ(std::string(id, id_len), "k1");
+  EXPECT_EQ(ydb_resultset_get_utf8(rs, 1, &name, &name_len, nullptr),
+            YDB_ERR_NOT_FOUND);
+
+  ydb_resultset_free(rs);
+}
+
+TEST(ResultSet, FetchColumnsStopsWhenStringDataRunsOut) {
+  YdbResultSet *rs = MakeStringResultSet();
+
+  char id_data[3];
+  uint32_t id_offsets[3];
+  char name_data[8];
+  uint32_t name_offsets[3];
+  uint8_t name_validity[1] = {0};
+  YdbColumnBuffer cols[2] = {};
+  cols[0].values = id_data;
+  cols[0].data_capacity = sizeof(id_data);
+  cols[0].offsets = id_offsets;
+  cols[1].values = name_data;
+  cols[1].data_capacity = sizeof(name_data);
+  cols[1].offsets = name_offsets;
+  cols[1].validity = name_validity;
+
+  // "k1" + "k2" does not fit into three bytes, so the second row waits
+  size_t rows = 0;
+  ASSERT_EQ(ydb_resultset_fetch_columns(rs, 2, cols, &rows, nullptr), YDB_OK);
+  ASSERT_EQ(rows, 1u);
+  EXPECT_EQ(cols[0].type, YDB_TYPE_UTF8);
+  EXPECT_EQ(std::string(id_data, cols[0].data_len), "k1");
+  EXPECT_EQ(std::string(name_data, cols[1].data_len), "alice");
+  EXPECT_EQ(name_validity[0] & 1, 1);
+
+  ASSERT_EQ(ydb_resultset_fetch_columns(rs, 2, cols, &rows, nullptr), YDB_OK);
+  ASSERT_EQ(rows, 1u);
+  EXPECT_EQ(std::string(id_data, cols[0].data_len), "k2");
+  EXPECT_EQ(cols[1].null_count, 1u);
+  EXPECT_EQ(name_validity[0] & 1, 0);
+
+  ASSERT_EQ(ydb_resultset_fetch_columns(rs, 2, cols, &rows, nullptr), YDB_OK);
+  EXPECT_EQ(rows, 0u);
+
+  ydb_resultset_free(rs);
+}
+
+TEST(ResultSet, ExportsArrowRecordBatch) {
+  YdbResultSet *rs = MakeStringResultSet();
+
+  ArrowSchema schema{};
+  ArrowArray array{};
+  ASSERT_EQ(ydb_resultset_export_arrow(rs, &schema, &array, nullptr), YDB_OK);
+  ydb_resultset_free(rs);
+
+  EXPECT_STREQ(schema.format, "+s");
+  ASSERT_EQ(schema.n_children, 2);
+  EXPECT_STREQ(schema.children[0]->name, "id");
+  EXPECT_STREQ(schema.children[1]->format, "u");
+  EXPECT_EQ(schema.children[1]->flags & ARROW_FLAG_NULLABLE,
+            ARROW_FLAG_NULLABLE);
+
+  ASSERT_EQ(array.length, 2);
+  ASSERT_EQ(array.n_children, 2);
+  const ArrowArray *name = array.children[1];
+  EXPECT_EQ(name->null_count, 1);
+  const auto *validity = static_cast<const uint8_t *>(name->buffers[0]);
+  const auto *offsets = static_cast<const int32_t *>(name->buffers[1]);
+  const auto *data = static_cast<const char *>(name->buffers[2]);
+  EXPECT_EQ(validity[0] & 0x3, 0x1);
+  EXPECT_EQ(std::string(data + offsets[0], offsets[1] - offsets[0]), "alice");
+  EXPECT_EQ(offsets[2], offsets[1]);
+
+  array.release(&array);
+  schema.release(&schema);
+  EXPECT_EQ(array.release, nullptr);
+  EXPECT_EQ(schema.release, nullptr);
+}
+
+TEST(ResultSet, SchemaUnwrapsOptionalColumns) {
+  YdbResultSet *rs = MakeStringResultSet();
+
+  const YdbColumnInfo *schema = nullptr;
+  int n = 0;
+  ASSERT_EQ(ydb_resultset_schema(rs, &schema, &n, nullptr), YDB_OK);
+  ASSERT_EQ(n, 2);
+  EXPECT_STREQ(schema[0].name, "id");
+  EXPECT_EQ(schema[0].type, YDB_TYPE_UTF8);
+  EXPECT_EQ(schema[0].nullable, 0);
+  EXPECT_EQ(schema[1].type, YDB_TYPE_UTF8);
+  EXPECT_EQ(schema[1].nullable, 1);
+  EXPECT_EQ(ydb_resultset_column_type(rs, 1, nullptr), YDB_TYPE_OPTIONAL);
+
+  ydb_resultset_free(rs);
+}
+
+namespace {
+// columns: i32 Int32, u8 Optional<Uint8>, f Float, ts Timestamp, id Uuid,
+// amount Decimal(22, 9)
+YdbResultSet *MakeTypedResultSet() {
+  Ydb::ResultSet proto;
+  auto add_column = [&](const char *name) {
+    auto *column = proto.add_columns();
+    column->set_name(name);
+    return column->mutable_type();
+  };
+  add_column("i32")->set_type_id(Ydb::Type::INT32);
+  add_column("u8")->mutable_optional_type()->mutable_item()->set_type_id(
+      Ydb::Type::UINT8);
+  add_column("f")->set_type_id(Ydb::Type::FLOAT);
+  add_column("ts")->set_type_id(Ydb::Type::TIMESTAMP);
+  add_column("id")->set_type_id(Ydb::Type::UUID);
+  auto *decimal = add_column("amount")->mutable_decimal_type();
+  decimal->set_precision(22);
+  decimal->set_scale(9);
+
+  auto *row = proto.add_rows();
+  row->add_items()->set_int32_value(-7);
+  row->add_items()->set_uint32_value(200);
+  row->add_items()->set_float_value(1.5f);
+  row->add_items()->set_uint64_value(1700000000000000);
+  auto *uuid = row->add_items();
+  uuid->set_low_128(0x0706050403020100);
+  uuid->set_high_128(0x0f0e0d0c0b0a0908);
+  auto *amount = row->add_items();
+  amount->set_low_128(1500000000);
+  amount->set_high_128(0);
+
+  row = proto.add_rows();
+  row->add_items()->set_int32_value(0);
+  row->add_items()->set_null_flag_value(google::protobuf::NULL_VALUE);
+  row->add_items()->set_float_value(0);
+  row->add_items()->set_uint64_value(0);
+  for (int i = 0; i < 2; ++i) {
+    auto *zero = row->add_items();
+    zero->set_low_128(0);
+    zero->set_high_128(0);
+  }
+
+  return new YdbResultSet(NYdb::TResultSet(std::move(proto)));
+}
+} // namespace
+
+TEST(ResultSet, TypedGettersWidenWithoutLoss) {
+  YdbResultSet *rs = MakeTypedResultSet();
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+
+  int32_t i32 = 0;
+  int64_t i64 = 0;
+  uint32_t u32 = 0;
+  float f = 0;
+  double d = 0;
+  uint64_t ts = 0;
+  EXPECT_EQ(ydb_resultset_get_int32(rs, 0, &i32, nullptr), YDB_OK);
+  EXPECT_EQ(i32, -7);
+  EXPECT_EQ(ydb_resultset_get_int64(rs, 0, &i64, nullptr), YDB_OK);
+  EXPECT_EQ(i64, -7);
+  EXPECT_EQ(ydb_resultset_get_uint32(rs, 1, &u32, nullptr), YDB_OK);
+  EXPECT_EQ(u32, 200u);
+  EXPECT_EQ(ydb_resultset_get_int32(rs, 1, &i32, nullptr), YDB_OK);
+  EXPECT_EQ(i32, 200);
+  EXPECT_EQ(ydb_resultset_get_float(rs, 2, &f, nullptr), YDB_OK);
+  EXPECT_EQ(f, 1.5f);
+  EXPECT_EQ(ydb_resultset_get_double(rs, 2, &d, nullptr), YDB_OK);
+  EXPECT_EQ(d, 1.5);
+  EXPECT_EQ(ydb_resultset_get_timestamp(rs, 3, &ts, nullptr), YDB_OK);
+  EXPECT_EQ(ts, 1700000000000000u);
+
+  uint8_t uuid[16] = {};
+  ASSERT_EQ(ydb_resultset_get_uuid(rs, 4, uuid, nullptr), YDB_OK);
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(uuid[i], i);
+  }
+
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+  u32 = 42;
+  EXPECT_EQ(ydb_resultset_get_uint32(rs, 1, &u32, nullptr),
+            YDB_ERR_NOT_FOUND);
+  EXPECT_EQ(u32, 42u);
+
+  ydb_resultset_free(rs);
+}
+
+TEST(ResultSet, TypedGettersRejectMismatchedTypes) {
+  YdbResultSet *rs = MakeTypedResultSet();
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+
+  uint64_t u64 = 42;
+  EXPECT_EQ(ydb_resultset_get_uint64(rs, 0, &u64, nullptr),
+            YDB_ERR_BAD_REQUEST);
+  EXPECT_EQ(u64, 42u);
+  float f = 0;
+  EXPECT_EQ(ydb_resultset_get_float(rs, 3, &f, nullptr), YDB_ERR_BAD_REQUEST);
+  const char *s = nullptr;
+  size_t len = 0;
+  EXPECT_EQ(ydb_resultset_get_utf8(rs, 0, &s, &len, nullptr),
+            YDB_ERR_BAD_REQUEST);
+
+  YdbResultDetails *rd = ydb_result_details_create(0);
+  int32_t i32 = 0;
+  EXPECT_EQ(ydb_resultset_get_int32(rs, 3, &i32, rd), YDB_ERR_BAD_REQUEST);
+  EXPECT_EQ(ydb_result_details_code(rd), YDB_ERR_BAD_REQUEST);
+  ydb_result_details_free(rd);
+
+  ydb_resultset_free(rs);
+}
+
+TEST(ResultSet, GetValueReturnsTaggedCells) {
+  YdbResultSet *rs = MakeTypedResultSet();
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+
+  YdbValue v;
+  ASSERT_EQ(ydb_resultset_get_value(rs, 0, &v, nullptr), YDB_OK);
+  EXPECT_EQ(v.type, YDB_TYPE_INT32);
+  EXPECT_FALSE(v.is_null);
+  EXPECT_EQ(v.value.i64, -7);
+
+  ASSERT_EQ(ydb_resultset_get_value(rs, 1, &v, nullptr), YDB_OK);
+  EXPECT_EQ(v.type, YDB_TYPE_UINT8);
+  EXPECT_EQ(v.value.u64, 200u);
+
+  ASSERT_EQ(ydb_resultset_get_value(rs, 5, &v, nullptr), YDB_OK);
+  EXPECT_EQ(v.type, YDB_TYPE_DECIMAL);
+  EXPECT_EQ(v.value.decimal.low, 1500000000u);
+  EXPECT_EQ(v.value.decimal.high, 0);
+  EXPECT_EQ(v.value.decimal.precision, 22);
+  EXPECT_EQ(v.value.decimal.scale, 9);
+
+  ASSERT_EQ(ydb_resultset_next_row(rs, nullptr), 1);
+  ASSERT_EQ(ydb_resultset_get_value(rs, 1, &v, nullptr), YDB_OK);
+  EXPECT_EQ(v.type, YDB_TYPE_UINT8);
+  EXPECT_TRUE(v.is_null);
+  EXPECT_EQ(ydb_resultset_is_null(rs, 0, nullptr), 0);
+  EXPECT_EQ(ydb_resultset_is_null(rs, 1, nullptr), 1);
+
+  EXPECT_EQ(ydb_resultset_get_value(rs, 6, &v, nullptr), YDB_ERR_BAD_REQUEST);
+  ydb_resultset_free(rs);
+}
@@ -4,6 +4,8 @@
 #include "ydb.h"
 #include "ydb_error.h"
 
+#include <ydb-cpp-sdk/client/types/status_codes.h>
+
 namespace {
 YdbResultDetails MakeDetails(ydb_status_t code = YDB_OK) {
   YdbResultDetails rd;
@@ -60,3 +62,143 @@ TEST(QueryRetrySettings, PerformRetryFailsForNonRetriableStatus) {
 
   ydb_query_retry_settings_free(rs, &rd);
 }
+
+namespace {
+YdbResultDetails MakeSdkDetails(NYdb::EStatus status) {
+  auto rd = MakeDetails(status_to_ydb_code(status));
+  rd.sdk_status = static_cast<int32_t>(status);
+  return rd;
+}
+} // namespace
+
+TEST(QueryRetrySettings, NextDelayDefaultsToConstantTimeout) {
+  auto rd = MakeSdkDetails(NYdb::EStatus::OVERLOADED);
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(3, 200, &rd);
+  ASSERT_NE(rs, nullptr);
+
+  uint64_t delay_us = 0;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &rd), YDB_OK);
+    EXPECT_EQ(delay_us, 200000u);
+  }
+  EXPECT_EQ(rs->current_retries, 3u);
+
+  ydb_query_retry_settings_free(rs, &rd);
+}
+
+TEST(QueryRetrySettings, SlowBackoffGrowsUpToCeiling) {
+  auto rd = MakeSdkDetails(NYdb::EStatus::OVERLOADED);
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(10, 0, &rd);
+  ASSERT_NE(rs, nullptr);
+  ASSERT_EQ(ydb_query_retry_settings_set_slow_backoff(rs, 10, 2, &rd), YDB_OK);
+
+  const uint64_t expected[] = {10000, 20000, 40000, 40000};
+  for (uint64_t want : expected) {
+    uint64_t delay_us = 0;
+    ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &rd), YDB_OK);
+    EXPECT_EQ(delay_us, want);
+  }
+
+  ydb_query_retry_settings_free(rs, &rd);
+}
+
+TEST(QueryRetrySettings, FastAndSlowClassesAreSeparate) {
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(10, 0, nullptr);
+  ASSERT_NE(rs, nullptr);
+  ASSERT_EQ(ydb_query_retry_settings_set_fast_backoff(rs, 1, 0, nullptr),
+            YDB_OK);
+  ASSERT_EQ(ydb_query_retry_settings_set_slow_backoff(rs, 500, 0, nullptr),
+            YDB_OK);
+
+  uint64_t delay_us = 0;
+  auto aborted = MakeSdkDetails(NYdb::EStatus::ABORTED);
+  ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &aborted), YDB_OK);
+  EXPECT_EQ(delay_us, 1000u);
+
+  auto exhausted = MakeSdkDetails(NYdb::EStatus::CLIENT_RESOURCE_EXHAUSTED);
+  ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &exhausted), YDB_OK);
+  EXPECT_EQ(delay_us, 500000u);
+
+  auto expired = MakeSdkDetails(NYdb::EStatus::SESSION_EXPIRED);
+  ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &expired), YDB_OK);
+  EXPECT_EQ(delay_us, 0u);
+
+  ydb_query_retry_settings_free(rs, nullptr);
+}
+
+TEST(QueryRetrySettings, MaxBackoffCapsDelay) {
+  auto rd = MakeSdkDetails(NYdb::EStatus::OVERLOADED);
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(10, 0, &rd);
+  ASSERT_NE(rs, nullptr);
+  ASSERT_EQ(ydb_query_retry_settings_set_slow_backoff(rs, 100, 10, &rd),
+            YDB_OK);
+  ASSERT_EQ(ydb_query_retry_settings_set_max_backoff(rs, 250, &rd), YDB_OK);
+
+  uint64_t delay_us = 0;
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &rd), YDB_OK);
+    EXPECT_LE(delay_us, 250000u);
+  }
+  EXPECT_EQ(delay_us, 250000u);
+
+  ydb_query_retry_settings_free(rs, &rd);
+}
+
+TEST(QueryRetrySettings, MaxBackoffShrinksSdkBackoff) {
+  // 100 ms * 2^1 is the largest delay within 250 ms
+  const auto capped = ydb_retry_backoff_capped({100, 10}, 250);
+  EXPECT_EQ(capped.slot_ms, 100u);
+  EXPECT_EQ(capped.ceiling, 1u);
+
+  const auto below_slot = ydb_retry_backoff_capped({100, 10}, 40);
+  EXPECT_EQ(below_slot.slot_ms, 40u);
+  EXPECT_EQ(below_slot.ceiling, 0u);
+
+  const auto within = ydb_retry_backoff_capped({10, 2}, 1000);
+  EXPECT_EQ(within.slot_ms, 10u);
+  EXPECT_EQ(within.ceiling, 2u);
+
+  const auto uncapped = ydb_retry_backoff_capped({100, 10}, 0);
+  EXPECT_EQ(uncapped.slot_ms, 100u);
+  EXPECT_EQ(uncapped.ceiling, 10u);
+}
+
+TEST(QueryRetrySettings, JitterStaysWithinRatio) {
+  auto rd = MakeSdkDetails(NYdb::EStatus::OVERLOADED);
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(1000, 100, &rd);
+  ASSERT_NE(rs, nullptr);
+  ASSERT_EQ(ydb_query_retry_settings_set_jitter(rs, 0.5, &rd), YDB_OK);
+  EXPECT_EQ(ydb_query_retry_settings_set_jitter(rs, 1.5, nullptr),
+            YDB_ERR_BAD_REQUEST);
+
+  bool varied = false;
+  uint64_t first = 0;
+  for (int i = 0; i < 100; ++i) {
+    uint64_t delay_us = 0;
+    ASSERT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &rd), YDB_OK);
+    EXPECT_GE(delay_us, 50000u);
+    EXPECT_LE(delay_us, 100000u);
+    if (i == 0) {
+      first = delay_us;
+    } else if (delay_us != first) {
+      varied = true;
+    }
+  }
+  EXPECT_TRUE(varied);
+
+  ydb_query_retry_settings_free(rs, &rd);
+}
+
+TEST(QueryRetrySettings, DeadlineStopsRetries) {
+  auto rd = MakeSdkDetails(NYdb::EStatus::UNAVAILABLE);
+  YdbQueryRetrySettings *rs = ydb_query_retry_settings_create(10, 50, &rd);
+  ASSERT_NE(rs, nullptr);
+  ASSERT_EQ(ydb_query_retry_settings_set_deadline(rs, 10, &rd), YDB_OK);
+
+  uint64_t delay_us = 0;
+  EXPECT_EQ(ydb_query_retry_next_delay(rs, &delay_us, &rd),
+            YDB_ERR_RETRY_FAILED);
+  EXPECT_EQ(rs->current_retries, 0u);
+
+  ydb_query_retry_settings_free(rs, &rd);
+}
@@ -12,6 +12,20 @@ TEST(StatusMapping, MapsKnownDriverStatuses) {
   EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::NOT_FOUND), YDB_ERR_NOT_FOUND);
   EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::INTERNAL_ERROR), YDB_ERR_INTERNAL);
   EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::TIMEOUT), YDB_ERR_TIMEOUT);
+  EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::CLIENT_DEADLINE_EXCEEDED),
+            YDB_ERR_TIMEOUT);
+  EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::CANCELLED), YDB_ERR_CANCELLED);
+}
+
+TEST(StatusMapping, AuthFailuresAreNotRetriable) {
+  EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::CLIENT_UNAUTHENTICATED),
+            YDB_ERR_UNAUTHORIZED);
+  EXPECT_EQ(status_to_ydb_code(NYdb::EStatus::UNAUTHORIZED),
+            YDB_ERR_UNAUTHORIZED);
+  EXPECT_EQ(ydb_is_status_retriable(YDB_ERR_UNAUTHORIZED), 0);
+  EXPECT_EQ(ydb_is_status_retriable(static_cast<ydb_status_t>(
+                NYdb::EStatus::CLIENT_UNAUTHENTICATED)),
+            0);
 }
 
 TEST(StatusMapping, MapsTransientStatusesToConnection) {
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "internal.hpp"
+
+#include <src/api/protos/ydb_value.pb.h>
+
+#include <stdexcept>
+
+// a single non-null column `id` holding 0 .. rows - 1; type is INT32 or
+// INT64
+inline NYdb::TResultSet MakeIdSet(int rows, Ydb::Type::PrimitiveTypeId type) {
+  if (type != Ydb::Type::INT32 && type != Ydb::Type::INT64) {
+    throw std::invalid_argument("MakeIdSet supports INT32 and INT64 only");
+  }
+  Ydb::ResultSet proto;
+  auto *id = proto.add_columns();
+  id->set_name("id");
+  id->mutable_type()->set_type_id(type);
+  for (int i = 0; i < rows; ++i) {
+    auto *item = proto.add_rows()->add_items();
+    if (type == Ydb::Type::INT32) {
+      item->set_int32_value(i);
+    } else {
+      item->set_int64_value(i);
+    }
+  }
+  return NYdb::TResultSet(std::move(proto));
+}
+
+inline YdbResultSet *MakeIdResultSet(int rows,
+                                     Ydb::Type::PrimitiveTypeId type) {
+  return new YdbResultSet(MakeIdSet(rows, type));
+}
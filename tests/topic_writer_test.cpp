@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+// the SDK session is not needed to wait on the shared writer state
+YdbTopicWriter MakeWriter() {
+  YdbTopicWriter w;
+  w.state = std::make_shared<YdbTopicWriterState>();
+  return w;
+}
+} // namespace
+
+TEST(TopicWriter, WaitReadyTimesOutWithoutCapacity) {
+  YdbTopicWriter w = MakeWriter();
+  YdbResultDetails *rd = ydb_result_details_create(0);
+
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(ydb_topic_writer_wait_ready(&w, 20, rd), YDB_ERR_TIMEOUT);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(20));
+  EXPECT_EQ(ydb_result_details_code(rd), YDB_ERR_TIMEOUT);
+
+  ydb_result_details_free(rd);
+}
+
+TEST(TopicWriter, WaitReadyWakesWhenSessionCloses) {
+  YdbTopicWriter w = MakeWriter();
+  std::thread closer([state = w.state] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    {
+      std::lock_guard lock(state->mutex);
+      state->closed.emplace(NYdb::TStatus(NYdb::EStatus::UNAVAILABLE, {}));
+    }
+    state->ready.notify_all();
+  });
+
+  EXPECT_EQ(ydb_topic_writer_wait_ready(&w, 10000, nullptr),
+            YDB_ERR_CONNECTION);
+  closer.join();
+  // a closed writer answers at once, whatever the timeout
+  EXPECT_EQ(ydb_topic_writer_wait_ready(&w, 10000, nullptr),
+            YDB_ERR_CONNECTION);
+}
+
+TEST(TopicWriter, WaitReadyRejectsNullWriter) {
+  EXPECT_EQ(ydb_topic_writer_wait_ready(nullptr, 0, nullptr),
+            YDB_ERR_BAD_REQUEST);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "internal.hpp"
+#include "test_helpers.hpp"
+#include "ydb.h"
+#include "ydb_error.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Recorded {
+  std::vector<std::string> started;
+  std::vector<std::string> attributes;
+  std::vector<ydb_status_t> ended;
+  int handles = 0;
+};
+
+void *StartSpan(const char *name, const YdbSpanAttribute *attrs,
+                size_t n_attrs, void *user_data) {
+  auto *recorded = static_cast<Recorded *>(user_data);
+  recorded->started.emplace_back(name);
+  for (size_t i = 0; i < n_attrs; ++i) {
+    recorded->attributes.push_back(std::string(attrs[i].key) + "=" +
+                                   attrs[i].value);
+  }
+  return &++recorded->handles;
+}
+
+void EndSpan(void *span, ydb_status_t status, uint64_t, void *user_data) {
+  auto *recorded = static_cast<Recorded *>(user_data);
+  EXPECT_EQ(span, &recorded->handles);
+  recorded->ended.push_back(status);
+}
+
+std::shared_ptr<const YdbTracer> MakeTracer(Recorded *recorded) {
+  return std::make_shared<const YdbTracer>(
+      YdbTracer{StartSpan, EndSpan, recorded});
+}
+
+} // namespace
+
+TEST(Tracing, SpanEndsOnceWithExplicitStatus) {
+  Recorded recorded;
+  {
+    YdbSpan span(MakeTracer(&recorded), "op", {{"db.system", "ydb"}});
+    EXPECT_EQ(span.end(YDB_ERR_TIMEOUT), YDB_ERR_TIMEOUT);
+  }
+  ASSERT_EQ(recorded.started, std::vector<std::string>{"op"});
+  EXPECT_EQ(recorded.attributes, std::vector<std::string>{"db.system=ydb"});
+  EXPECT_EQ(recorded.ended, std::vector<ydb_status_t>{YDB_ERR_TIMEOUT});
+}
+
+TEST(Tracing, UnwoundSpanReportsInternalError) {
+  Recorded recorded;
+  { YdbSpan span(MakeTracer(&recorded), "op"); }
+  EXPECT_EQ(recorded.ended, std::vector<ydb_status_t>{YDB_ERR_INTERNAL});
+}
+
+TEST(Tracing, NoTracerIsANoOp) {
+  YdbSpan span(nullptr, "op");
+  EXPECT_EQ(span.end(YDB_OK), YDB_OK);
+}
+
+TEST(Tracing, ResultSetIterationIsOneSpan) {
+  Recorded recorded;
+  YdbResultSet *rs = MakeIdResultSet(3, Ydb::Type::INT32);
+  rs->tracer = MakeTracer(&recorded);
+
+  int rows = 0;
+  while (ydb_resultset_next_row(rs, nullptr) == 1) {
+    ++rows;
+  }
+  EXPECT_EQ(rows, 3);
+  EXPECT_EQ(ydb_resultset_next_row(rs, nullptr), 0);
+  ydb_resultset_free(rs);
+
+  ASSERT_EQ(recorded.started,
+            std::vector<std::string>{"ydb.ResultSet.iterate"});
+  EXPECT_EQ(recorded.attributes[1], "db.response.returned_rows=3");
+  EXPECT_EQ(recorded.ended, std::vector<ydb_status_t>{YDB_OK});
+}
+
+TEST(Tracing, ColumnarFetchIsOneIterationSpan) {
+  Recorded recorded;
+  YdbResultSet *rs = MakeIdResultSet(5, Ydb::Type::INT32);
+  rs->tracer = MakeTracer(&recorded);
+
+  int32_t ids[2] = {};
+  YdbColumnBuffer col = {};
+  col.values = ids;
+  size_t fetched = 0;
+  size_t total = 0;
+  do {
+    ASSERT_EQ(ydb_resultset_fetch_columns(rs, 2, &col, &fetched, nullptr),
+              YDB_OK);
+    total += fetched;
+  } while (fetched == 2);
+  EXPECT_EQ(total, 5u);
+  ydb_resultset_free(rs);
+
+  ASSERT_EQ(recorded.started,
+            std::vector<std::string>{"ydb.ResultSet.iterate"});
+  EXPECT_EQ(recorded.ended, std::vector<ydb_status_t>{YDB_OK});
+}
+
+TEST(Tracing, QueryTextIsOptInAndBounded) {
+  Recorded recorded;
+  YdbDriver drv;
+  ASSERT_EQ(ydb_driver_set_tracer(&drv, StartSpan, EndSpan, &recorded,
+                                  nullptr),
+            YDB_OK);
+  ydb_query_span(&drv, "SELECT 1;").end(YDB_OK);
+  EXPECT_EQ(recorded.attributes, std::vector<std::string>{"db.system=ydb"});
+
+  recorded.attributes.clear();
+  ASSERT_EQ(ydb_driver_set_trace_query_text(&drv, 9, nullptr), YDB_OK);
+  // the two-byte "ё" straddles the limit and is left out whole
+  ydb_query_span(&drv, "SELECT '\u0451';").end(YDB_OK);
+  EXPECT_EQ(recorded.attributes,
+            (std::vector<std::string>{"db.system=ydb",
+                                      "db.query.text=SELECT '"}));
+  EXPECT_EQ(recorded.started.size(), 2u);
+}
+
+TEST(Tracing, TraceParentIsThreadLocal) {
+  const char *parent =
+      "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+  ASSERT_EQ(ydb_trace_set_parent(parent, nullptr), YDB_OK);
+  EXPECT_EQ(ydb_trace_parent(), parent);
+
+  std::string other = "unset";
+  std::thread([&] { other = ydb_trace_parent(); }).join();
+  EXPECT_EQ(other, "");
+
+  ASSERT_EQ(ydb_trace_set_parent(nullptr, nullptr), YDB_OK);
+  EXPECT_EQ(ydb_trace_parent(), "");
+}